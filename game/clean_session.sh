@@ -1,3 +1,4 @@
 rm system.log
+rm metrics.bin metrics.bin.idx
 rm -r models/*
 rm -r logs
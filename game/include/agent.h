@@ -9,12 +9,31 @@
 #include <policy.h>
 #include <rl_utils.h>
 #include <io_frontend.h>
+#include <replay_buffer.h>
+#include <aligned_allocator.h>
+#include <config.h>
+#include <transition_queue.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
 
 #define TARGET_NN_UPDATE_INTERVAL 1000
 
-extern IO_FRONTEND::RND_Params rnd_parameters;
-extern IO_FRONTEND::DQN_Params dqn_parameters;
-extern IO_FRONTEND::BoltzmannPolicy_Params boltzmann_parameters;
+// Checkpoint directories: the Trainer loads its networks from them if they exist and
+// saveModels writes them back to the same place
+#define DQN_MODEL_PATH "models/dqn_model"
+#define RND_PREDICTOR_PATH "models/rnd_model/test_model/predictor"
+#define RND_TARGET_PATH "models/rnd_model/test_model/target"
+
+// Everything needed to resume training besides the network checkpoints (which carry the
+// optimizer state themselves): learner counters, policy temperature, reward statistics and
+// both replay buffers. The RND statistics and buffer only make sense with the RND target they
+// were computed with, so the state also records a fingerprint of that network
+#define TRAINING_STATE_PATH "models/training_state.bin"
+#define TRAINING_STATE_VERSION 2
+
 
 class Agent {
     private:
@@ -29,13 +48,19 @@ class Agent {
     public:
         Agent(Organism* organism);
 
+        // Agents own their policy, so they can be moved into contiguous storage but not copied
+        Agent(Agent&& other) noexcept;
+        Agent(const Agent&) = delete;
+        Agent& operator=(const Agent&) = delete;
+
         void setPolicy(PolicyType policy_type);
 
         ~Agent();
         
         void updateState(Map* map, bool is_eating);
         
-        Action chooseAction();
+        // Picks the action for the current state from the Q-values of network
+        Action chooseAction(nn_network* network);
 
         State getState() const { return m_state; }
         
@@ -47,25 +72,114 @@ class Trainer {
     private:
         Agent* m_agent;
         Map* m_map;
+        std::string m_model_path; // DQN checkpoint directory
 
         double m_discount_factor;
         double m_learning_rate;
 
         
-        std::vector<Transition> replay_buffer;
+        ReplayBuffer m_replay_buffer; // encoded DQN transitions
         int replay_buffer_size;
         int batch_size;
         int learning_counter;
 
 
-        RND_replay_buffer m_rnd_replay_buffer;
+        ReplayBuffer m_rnd_replay_buffer; // encoded RND inputs, states only, plus their RND target outputs
         int m_rnd_counter;
 
-        int target_nn_update_counter;
+        std::vector<size_t> m_batch_slots; // slots sampled for the current batch
+
+        // Batch buffers, sized once in the constructor and reused by every learn step.
+        // Sampled rows are gathered straight into them and they go to nn_predict/nn_train as is
+        AlignedVector<double> m_states_batch;
+        AlignedVector<double> m_next_states_batch;
+        AlignedVector<double> m_q_next_target;
+        AlignedVector<double> m_target_values;
+
+        AlignedVector<double> m_rnd_input_batch;
+        AlignedVector<double> m_rnd_target_batch;
+
+        // Deferred RND (RND_DEFERRED = 1): RND inputs, predictor/target outputs and intrinsic
+        // reward terms of the sampled DQN batch
+        AlignedVector<double> m_batch_rnd_inputs;
+        AlignedVector<double> m_batch_rnd_pred;
+        AlignedVector<double> m_batch_rnd_target;
+        std::vector<double> m_batch_intrinsic;
+
+        // Per-step RND (RND_DEFERRED = 0): input and predictor/target outputs of the current
+        // step, acting side only
+        AlignedVector<double> m_step_rnd_input;
+        AlignedVector<double> m_step_rnd_pred;
+        AlignedVector<double> m_step_rnd_target;
+
+        // prioritized replay: importance-sampling weights and TD errors of the current batch
+        std::vector<double> m_batch_weights;
+        std::vector<double> m_td_errors;
+        long m_learn_steps = 0; // DQN batches trained, anneals the PER beta
+        size_t m_stats_new_samples = 0; // transitions stored since the last deferred stats update
+
+        // The networks this trainer trains, owned by it
+        nn_network* m_dqn_online = nullptr;
+        nn_network* m_dqn_target = nullptr;
+        nn_network* m_rnd_predictor = nullptr;
+        nn_network* m_rnd_target = nullptr;
+
+        // What the acting side predicts with: the networks above, or actor copies owned by this
+        // trainer when the async learner runs
+        ActorNetworks m_actor;
+
+        // Normalizer of the RND novelty, per-step or per-batch (deferred) alike
+        stats::Normalizer m_novelty_stats;
+
+        int target_nn_update_counter = 0;
         std::mt19937 m_gen;
 
         bool m_rndEnabled;
 
+        // Async learner (ASYNC_LEARNER = 1). The actor encodes transitions into m_queue, the
+        // learner thread moves them into the replay buffers and trains there, so the replay
+        // buffers, the counters above and the networks above belong to the learner.
+        // The actor predicts with copies (m_actor) that adopt the weights the learner
+        // publishes every PUBLISH_INTERVAL DQN steps, handed over through staging copies
+        std::unique_ptr<TransitionQueue> m_queue;
+        std::thread m_learner;
+        std::atomic<bool> m_learner_stop{false};
+        std::atomic<bool> m_pause_requested{false};
+        std::mutex m_learner_mutex;
+        std::condition_variable m_learner_cv;
+        int m_pause_depth = 0;
+        bool m_learner_paused = false;
+
+        nn_network* m_staging_dqn = nullptr;
+        nn_network* m_staging_rnd = nullptr;
+        std::mutex m_publish_mutex;
+        std::atomic<uint64_t> m_published_version{0};
+        uint64_t m_adopted_version = 0; // actor side
+        int m_steps_since_publish = 0;  // learner side
+
+        void startLearner();
+        void stopLearner();
+        void learnerLoop();
+        size_t drainQueue();
+
+        // Target sync and the DQN/RND learn cadence, run once per stored transition
+        void trainOnSchedule();
+
+        // The RND target never trains, so its output for a stored input is computed once and
+        // cached next to it. Runs a target pass over the inputs without one, a batch at a time:
+        // unless flush is set only once a full RND batch has piled up (and while RND is on).
+        // A reloaded target has a new parameter version, which invalidates the whole cache
+        void embedRNDTargets(bool flush);
+
+        // Weighted sum of the RND target's outputs for a fixed input, identical only for
+        // identical weights
+        double rndTargetFingerprint();
+
+        void publishWeights();
+        void adoptPublishedWeights();
+
+        std::vector<uint64_t> m_checkpoint_tickets; // saves still being written in the background
+
     public:
         Trainer(Agent* agent, Map* map, double discount_factor, double learning_rate, std::string model_path, int buffer_size, bool enable_rnd);
 
@@ -78,15 +192,48 @@ class Trainer {
         void learn_from_batch();
 
         void rnd_learn_from_batch();
+
+        // beta * max(0, z) for every sampled transition into m_batch_intrinsic, from the
+        // predictor/target outputs learn_from_batch put in m_batch_rnd_pred/m_batch_rnd_target.
+        // Updates the novelty normalizer once for the batch
+        void computeBatchIntrinsicRewards();
         
         void learn(State state, State prevState, Action action, double reward, bool isDone = false, 
                    std::vector<double> food_rates = {}, uint32_t organism_sector = 0);
 
-        void updateReplayBuffer(Transition transition);
+        void updateReplayBuffer(const Transition& transition);
+
+        const ReplayBuffer& getReplayBuffer() const { return m_replay_buffer; }
+
+        // Networks the acting side predicts with, valid as long as the trainer
+        const ActorNetworks& actorNetworks() const { return m_actor; }
+
+        // For computeReward on the acting side
+        IntrinsicRewardContext intrinsicRewardContext() {
+            return {&m_actor, &m_novelty_stats, m_step_rnd_input.data(), m_step_rnd_pred.data(), m_step_rnd_target.data()};
+        }
+
+        void setRNDEnabled(bool enabled);
+
+        // Park the learner thread at a batch boundary, after it has stored every queued
+        // transition, so the actor thread can read or change what it owns (weights, buffers,
+        // config). Calls nest; no-ops without an async learner
+        void pauseLearner();
+        void resumeLearner();
+
+        // Checkpoint the online DQN and both RND networks. Only copies the weights, the files
+        // are written in the background; failures of earlier saves are reported here
+        void saveModels();
 
-        std::vector<Transition> getReplayBuffer() const { return replay_buffer; }
+        // Block until every pending checkpoint is on disk, false if any of them failed
+        bool waitForCheckpoints();
 
-        void setRNDEnabled(bool enabled) { m_rndEnabled = enabled; }
+        // Write/restore the resumable training state (see TRAINING_STATE_PATH). policy may be
+        // nullptr. Meant for a freshly constructed trainer: loadTrainingState returns false if
+        // the file is missing, truncated or does not match the current params, leaving the
+        // trainer as it was
+        bool saveTrainingState(const std::string& path, const BoltzmannPolicy* policy);
+        bool loadTrainingState(const std::string& path, BoltzmannPolicy* policy);
 
 
 };
@@ -0,0 +1,38 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <string>
+#include <cstdint>
+#include <io_frontend.h>
+
+#define RL_PARAMS_PATH "../game/rl_system.params"
+
+// Process-wide configuration. rl_system.params (and nn_system.params, through
+// parse_nn_params) is parsed once by config::load() at startup; everything afterwards reads
+// the parsed values straight from these globals, so no file I/O happens in the step loop.
+extern IO_FRONTEND::RND_Params rnd_parameters;
+extern IO_FRONTEND::DQN_Params dqn_parameters;
+extern IO_FRONTEND::BoltzmannPolicy_Params boltzmann_parameters;
+extern IO_FRONTEND::PER_Params per_parameters;
+extern IO_FRONTEND::Learner_Params learner_parameters;
+extern int replay_buffer_capacity;
+
+namespace config {
+
+    // Parse both params files, a no-op returning true once loaded
+    bool load(const std::string& rl_params_path = RL_PARAMS_PATH);
+
+    // Re-read rl_system.params if it changed on disk since the last (re)load. Only call this at
+    // explicit points such as episode boundaries, with the learner paused. Network/buffer
+    // shapes, PRIORITIZED_REPLAY and the learner mode are fixed once the trainer exists, a
+    // reload that changes them is rejected and the old values are kept. Returns true if new
+    // values were applied
+    bool reload();
+
+    bool loaded();
+
+    // Incremented on every applied load/reload, lets consumers cache derived values
+    uint32_t generation();
+}
+
+#endif
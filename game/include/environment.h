@@ -0,0 +1,49 @@
+#ifndef ENVIRONMENT_H
+#define ENVIRONMENT_H
+
+#include <map.h>
+#include <organism.h>
+#include <agent.h>
+#include <rl_utils.h>
+#include <random>
+
+// One map + organism pair stepped by an agent/trainer. Holds no rendering state, so the
+// SDL game and the headless trainer drive exactly the same step loop.
+class Environment {
+    private:
+        Map* m_map;
+        Organism* m_organism;
+        Agent* m_agent;
+        Trainer* m_trainer;
+
+        int m_timestep = 0;
+        bool m_rndEnabled = false;
+
+        // tags for the per-step metrics records
+        uint32_t m_episode = 0;
+        uint16_t m_id = 0;
+
+        std::mt19937 m_gen;
+
+    public:
+        Environment(Map* map, Organism* organism, Agent* agent, Trainer* trainer);
+
+        // Regenerate the map and respawn the organism for a new episode
+        void reset();
+
+        // Apply one action, compute its reward and hand the transition to the trainer.
+        // Returns false once the organism has run out of energy.
+        bool step(Action action);
+
+        int getTimestep() const { return m_timestep; }
+
+        void setRNDEnabled(bool enabled) { m_rndEnabled = enabled; }
+
+        void setTrainer(Trainer* trainer) { m_trainer = trainer; }
+
+        void setEpisode(uint32_t episode) { m_episode = episode; }
+
+        void setId(uint16_t id) { m_id = id; }
+};
+
+#endif
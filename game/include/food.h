@@ -1,6 +1,8 @@
 #ifndef FOOD_H
 #define FOOD_H
+#ifndef HEADLESS
 #include <SDL.h>
+#endif
 #include <iostream>
 #include <sprites.h>
 
@@ -14,7 +16,9 @@ class Food : public Sprite {
 
         bool move(int dx, int dy) override;
 
+#ifndef HEADLESS
         void draw(SDL_Renderer* renderer) override;
+#endif
 };
 
 #endif
\ No newline at end of file
@@ -12,6 +12,7 @@
 #include <stdint.h>
 #include <nn_api.h>
 #include <agent.h>
+#include <environment.h>
 #include <stdbool.h>
 
 
@@ -23,6 +24,7 @@ class Game {
         Organism* m_organism;
         Agent* m_agent;
         Trainer* m_trainer;
+        Environment* m_env;
         
         enum class GameState { MENU, RUNNING, QUIT };
         GameState m_currentState;
@@ -32,7 +34,6 @@ class Game {
 
         bool m_rndEnabled;
 
-        int timestep = 0;
         std::vector<std::string> m_policies; // List of policies to choose from
         std::vector<bool> m_selectedPolicies; // Track selected policies
         
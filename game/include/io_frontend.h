@@ -11,6 +11,7 @@ namespace IO_FRONTEND {
         int RND_HIDDEN_DIM;
         int RND_NUM_LAYERS;
         int RND_BATCH_SIZE;
+        int RND_DEFERRED = 0; // 1: no RND on the acting path, intrinsic rewards are computed per sampled DQN batch
     };
 
     struct DQN_Params {
@@ -19,6 +20,7 @@ namespace IO_FRONTEND {
         int DQN_HIDDEN_DIM;
         int DQN_NUM_LAYERS;
         int DQN_BATCH_SIZE;
+        double TARGET_TAU = 0.0; // > 0: Polyak-average the target after every learn step, 0: hard sync every 2000 steps
     };
 
     bool parse_rnd_params(const std::string& param_file_path, RND_Params& rnd_params); // parse RND hyperparam file, return success or not
@@ -35,6 +37,24 @@ namespace IO_FRONTEND {
     bool parse_boltzmann_params(const std::string& param_file_path, BoltzmannPolicy_Params& bolzmann_params); // parse DQN hyperparam file, return success or not
 
     bool parse_buffer_capacity(const std::string& param_file_path, int& capacity);
+
+    struct PER_Params {
+        int PRIORITIZED_REPLAY = 0; // 1 samples the DQN replay buffer by TD-error priority
+        double PER_ALPHA = 0.6;      // priority exponent, 0 is uniform
+        double PER_BETA_START = 0.4; // importance-sampling exponent, annealed to 1
+        int PER_BETA_STEPS = 100000; // learner steps to anneal beta over
+        double PER_EPS = 1e-3;       // added to |TD error| so no transition gets priority 0
+    };
+
+    bool parse_per_params(const std::string& param_file_path, PER_Params& per_params); // parse prioritized replay params, return success or not
+
+    struct Learner_Params {
+        int ASYNC_LEARNER = 0;                // 1 trains on a separate thread fed by a transition queue
+        int PUBLISH_INTERVAL = 20;            // learner DQN steps between weight publishes to the actor
+        int TRANSITION_QUEUE_CAPACITY = 4096; // transitions in flight between actor and learner
+    };
+
+    bool parse_learner_params(const std::string& param_file_path, Learner_Params& learner_params); // parse actor/learner params, return success or not
 }
 
 #endif
\ No newline at end of file
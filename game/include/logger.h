@@ -5,6 +5,17 @@
 #include <fstream>
 #include <string>
 #include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <cstdint>
+#include <ctime>
+
+// Lowest level that is compiled in: 0 DEBUG, 1 INFO, 2 WARNING, 3 ERROR.
+// Build with -DLOG_MIN_LEVEL=1 (make LOG_MIN_LEVEL=1) to strip every DEBUG call site
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
 
 enum class LogType {
     DEBUG,
@@ -13,34 +24,83 @@ enum class LogType {
     ERROR
 };
 
+#define LOGGER_RING_SIZE 8192   // records, power of two
+#define LOGGER_RECORD_SIZE 256  // bytes per record, longer messages are truncated
+
+// printf-style logging, the arguments are not even evaluated when the level is compiled out
+#define LOG_AT(level, ...) \
+    do { if constexpr (Logger::enabled(level)) Logger::getInstance().logf(level, __VA_ARGS__); } while (0)
+#define LOG_DEBUG(...)   LOG_AT(LogType::DEBUG, __VA_ARGS__)
+#define LOG_INFO(...)    LOG_AT(LogType::INFO, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(LogType::WARNING, __VA_ARGS__)
+#define LOG_ERROR(...)   LOG_AT(LogType::ERROR, __VA_ARGS__)
+
+// Asynchronous logger. Callers format their message straight into a fixed-size record of a
+// lock-free ring (bounded MPMC queue, one sequence number per cell) and return; a background
+// thread stamps the time, formats the line and writes the file. The line format is unchanged:
+// "[YYYY-mm-dd HH:MM:SS] [LEVEL] message".
+// When the ring is full callers wait for the writer instead of dropping records.
 class Logger {
 public:
 
     static Logger& getInstance();
 
+    static constexpr bool enabled(LogType level) {
+        return static_cast<int>(level) >= LOG_MIN_LEVEL;
+    }
+
     void init(const std::string& filename);
 
     void log(LogType level, const std::string& message);
+    void logf(LogType level, const char* format, ...) __attribute__((format(printf, 3, 4)));
     void debug(const std::string& message);
     void info(const std::string& message);
     void warning(const std::string& message);
     void error(const std::string& message);
 
+    // Block until every record logged so far is written to the file
+    void flush();
+
 private:
+    struct alignas(64) Record {
+        std::atomic<size_t> sequence;
+        std::time_t time;
+        LogType level;
+        uint16_t length;
+        char text[LOGGER_RECORD_SIZE - sizeof(std::atomic<size_t>) - sizeof(std::time_t) - sizeof(LogType) - sizeof(uint16_t)];
+    };
+
     Logger() = default;
     ~Logger();
 
     std::ofstream m_logFile;
-    std::mutex m_mutex;
+    std::mutex m_mutex; // guards init only
     bool initialized = false;
 
+    std::unique_ptr<Record[]> m_ring;
+    alignas(64) std::atomic<size_t> m_enqueue_pos{0};
+    alignas(64) std::atomic<size_t> m_dequeue_pos{0};
+
+    std::thread m_writer;
+    std::atomic<bool> m_stop{false};
+
+    // writer thread only: the formatted timestamp is reused while the second doesn't change
+    std::time_t m_last_time = 0;
+    std::string m_last_time_str;
+
     // Prevent copying
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    std::string getCurrentTime();
-    std::string typeToString(LogType level);
+    Record* claim(size_t& pos);
+    void publish(Record* record, size_t pos);
+
+    void writerLoop();
+    size_t drain();
+
+    const std::string& formatTime(std::time_t time);
+    const char* typeToString(LogType level);
 
 };
 
-#endif // LOGGER_H
\ No newline at end of file
+#endif // LOGGER_H
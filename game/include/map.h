@@ -1,16 +1,29 @@
 #ifndef MAP_H
 #define MAP_H
+#ifndef HEADLESS
 #include <SDL.h>
+#endif
 #include <iostream>
+#include <tuple>
 #include <sprites.h>
 #include <food.h>
 #include <organism.h>
 #include <wall.h>
 #include <vector>
+#include <cstdint>
 #include <stdbool.h>
 
 #define CELL_SIZE 100 // Size of each cell in the grid
 
+#define MAP_WIDTH 900
+#define MAP_HEIGHT 900
+
+#define FOOD_BUCKET_SIZE 16 // side length in cells of one bucket of the food collision index
+
+// Default sector grid for the RND food histogram (RND_INPUT_DIM = 2 + sectors)
+#define FOOD_SECTORS_X 3
+#define FOOD_SECTORS_Y 3
+
 enum CellType {
     EMPTY = 0,
     WALL = 1,
@@ -21,9 +34,42 @@ enum CellType {
 class Map {
     private:
         int width, height; // Dimensions of the map
-        Sprite*** grid; // 2D array to represent the map
+        // World state: one CellType per cell, row-major (y * width + x)
+        std::vector<uint8_t> cells;
         int food_count = 0;
 
+        // Uniform bucket grid over food positions: each bucket lists the cell index
+        // (y * width + x) of every food inside it, so collision only visits food near the organism
+        int bucket_cols, bucket_rows;
+        std::vector<std::vector<int>> food_buckets;
+
+        // Summed-area table of wall cells, (width + 1) x (height + 1) with a zero first
+        // row/column, so the count in any rectangle is four lookups. Walls never change
+        std::vector<int32_t> wall_sat;
+
+        // Food changes as it is eaten, so its counts live in a 2D Fenwick tree of the same
+        // shape (1-based): removing one food and a prefix count are both O(log W * log H)
+        std::vector<int32_t> food_tree;
+
+        void buildCountTables();
+        void removeFoodFromCounts(int x, int y);
+
+        // food in cells [0, x) x [0, y)
+        int foodPrefix(int x, int y) const;
+
+        // number of cells counted inside [xmin, xmax] x [ymin, ymax] (inclusive, in bounds)
+        int wallRectSum(int xmin, int ymin, int xmax, int ymax) const;
+        int foodRectSum(int xmin, int ymin, int xmax, int ymax) const;
+
+        // Fill the map with border walls and food in food_per_10000 of the inner cells
+        void generate(int food_per_10000);
+
+        void clearFoodIndex();
+        void addFoodToIndex(int x, int y);
+
+        // Food count per sector, kept current on every place/eat so reads are O(1)
+        int sectors_x, sectors_y;
+        std::vector<double> sector_food_counts;
 
         // vector that contains the vision of the organism. tuple of (xmin, ymin, xmax, ymax)
         mutable std::tuple<int, int, int, int> org_vision;
@@ -32,11 +78,14 @@ class Map {
 
     public:
 
-        Map(int w, int h);
+        Map(int w, int h, int sectors_x = FOOD_SECTORS_X, int sectors_y = FOOD_SECTORS_Y);
 
-        void reset();
+        // Maps are large, so they can be moved into contiguous storage but not copied
+        Map(Map&& other) noexcept = default;
+        Map(const Map&) = delete;
+        Map& operator=(const Map&) = delete;
 
-        ~Map();
+        void reset();
 
         void addOrganism(int x, int y, Genome genome);
 
@@ -44,6 +93,8 @@ class Map {
 
         int getHeight() const;
 
+        uint8_t cellAt(int x, int y) const { return cells[static_cast<size_t>(y) * width + x]; }
+
         void organismCollisionFood(Sprite* sprite_org);
 
         bool isWall(int x, int y) const;
@@ -52,15 +103,22 @@ class Map {
 
         int getWallPosY(int x, int y) const;
 
+#ifndef HEADLESS
         void draw_map(SDL_Renderer* renderer);
 
         void drawVision(SDL_Renderer* renderer) const;
+#endif
         
         std::tuple<int, bool, int> getVision(int x, int y, Direction facing, int depth, int org_size) const;
 
         // RND related functions
-        // return vector of food counts and in each sector, 9 sectors in total
-        std::vector<double> getFoodCounts() const;
+        // food count in each sector, row-major over the sectors_x x sectors_y grid
+        const std::vector<double>& getFoodCounts() const { return sector_food_counts; }
+
+        // index of the sector containing cell (x, y)
+        uint32_t getSector(int x, int y) const;
+
+        int getNumSectors() const { return sectors_x * sectors_y; }
 
         bool isEating() const {
 
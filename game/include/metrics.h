@@ -0,0 +1,100 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Binary per-step metrics, replacing the regex-parsed DEBUG lines of system.log.
+//
+// <name>      16 byte header (MetricsFileHeader, magic "LIFEMET") followed by one
+//             StepMetrics record per environment step, little endian, no padding
+// <name>.idx  16 byte header (magic "LIFEIDX") followed by one EpisodeIndexEntry per
+//             finished episode
+//
+// Values that were not produced on a step (the RND terms with RND off) are NaN. With
+// several envs, records of concurrent episodes interleave; the index gives the record range
+// an episode lies in and the episode column selects its rows. Readers: bin/metrics_dump
+// (CSV) and load_metrics in performance_analysis.py. Bump METRICS_VERSION on layout changes.
+
+#define METRICS_VERSION 1
+
+#pragma pack(push, 1)
+struct MetricsFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+};
+
+struct StepMetrics {
+    uint32_t episode;
+    uint32_t step;        // timestep within the episode
+    uint16_t env;         // env index (VecEnv), 0 for the single-env game
+    uint8_t action;       // selected direction
+    uint8_t reserved;
+    float q_values[4];    // online Q-values the action was chosen from
+    float temperature;    // Boltzmann temperature after the decay
+    float energy;         // energy level before the step
+    float extrinsic_reward;
+    float total_reward;   // extrinsic + beta * max(0, z)
+    float beta;
+    float z_score;
+    float intrinsic_mse;
+};
+
+struct EpisodeIndexEntry {
+    uint32_t episode;
+    uint32_t length;       // steps
+    uint64_t first_record; // records of the episode lie in [first_record, end_record)
+    uint64_t end_record;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(StepMetrics) == 56, "StepMetrics layout is part of the file format");
+static_assert(sizeof(EpisodeIndexEntry) == 24, "EpisodeIndexEntry layout is part of the file format");
+
+class Metrics {
+public:
+
+    static Metrics& getInstance();
+
+    // Open (truncate) the metrics file and its index. Until init, every call is a no-op
+    bool init(const std::string& filename);
+
+    bool enabled() const { return m_enabled; }
+
+    // Fields of the step in progress, filled by whoever computes them
+    void recordAction(const double* q_values, int action, double temperature);
+    void recordIntrinsic(double mse, double z_score);
+    void recordReward(double extrinsic, double total, double beta);
+
+    // Append the step in progress and start a new one
+    void commitStep(uint32_t episode, uint32_t step, uint16_t env, double energy);
+
+    void beginEpisode(uint32_t episode);
+    void endEpisode(uint32_t episode, uint32_t length);
+
+    void flush();
+
+private:
+    Metrics() = default;
+    ~Metrics();
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    void clearPending();
+
+    bool m_enabled = false;
+    std::ofstream m_file;
+    std::ofstream m_index;
+
+    StepMetrics m_pending;
+    std::vector<StepMetrics> m_buffer; // written out in chunks
+    uint64_t m_records = 0;            // records appended so far (buffered included)
+    std::unordered_map<uint32_t, uint64_t> m_episode_start; // episode -> first record
+};
+
+#endif
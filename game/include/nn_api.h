@@ -1,3 +1,6 @@
+#ifndef NN_API_H
+#define NN_API_H
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -6,21 +9,190 @@ extern "C" {
 
 uint32_t parse_nn_params();
 
+// Handle API. Every network is an opaque nn_network owning its parameters, optimizer state and
+// scratch buffers, there is no shared instance table. Networks behind different handles can be
+// used from different threads at the same time; one handle must not be used concurrently.
+// nn_type only picks the loss log and is stored in checkpoints. The _f32 calls take float32
+// handles, the others float64 ones
+typedef struct nn_network nn_network;
+
+// Hyperparameters and loss log settings of one network. The network keeps its own copy, so
+// later changes (or a new parse_nn_params) don't touch networks that already exist
+typedef struct nn_options {
+    double lr_initial;
+    double beta1;
+    double beta2;
+    double eps;
+    int32_t max_training_steps;
+    double min_learning_rate;
+
+    int32_t loss_log_interval;
+    int32_t loss_log_mode;
+    int32_t loss_flush_lines;
+} nn_options;
+
+// The options nn_system.params gives nn_type (DQN for 0/1, RND for 2/3), as of the last
+// parse_nn_params
+nn_options nn_default_options(uint32_t nn_type);
+
+// nullptr if the network can't be created or loaded. nn_load converts a model saved in the
+// other precision
+nn_network* nn_create(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim,
+    uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type, const nn_options* options);
+nn_network* nn_create_f32(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim,
+    uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type, const nn_options* options);
+nn_network* nn_load(const char* dirname, const nn_options* options);
+nn_network* nn_load_f32(const char* dirname, const nn_options* options);
+
+// Independent copy with the same weights and optimizer state, but no loss log
+nn_network* nn_clone(nn_network* network);
+
+void nn_destroy(nn_network* network);
+
+void nn_predict(nn_network* network, double* input_data, double* output_data, uint32_t batch_size);
+void nn_predict_f32(nn_network* network, float* input_data, float* output_data, uint32_t batch_size);
+
+// predict_many for handles
+typedef struct nn_job {
+    nn_network* network;
+    double* input_data;
+    double* output_data;
+    uint32_t batch_size;
+} nn_job;
+
+typedef struct nn_job_f32 {
+    nn_network* network;
+    float* input_data;
+    float* output_data;
+    uint32_t batch_size;
+} nn_job_f32;
+
+void nn_predict_many(const nn_job* jobs, uint32_t count);
+void nn_predict_many_f32(const nn_job_f32* jobs, uint32_t count);
+
+// One training step on batch_size samples, any size (the one given at creation is only
+// recorded in checkpoints)
+void nn_train(nn_network* network, double* input_data, double* target_data, uint32_t batch_size);
+void nn_train_f32(nn_network* network, float* input_data, float* target_data, uint32_t batch_size);
+void nn_train_weighted(nn_network* network, double* input_data, double* target_data, double* sample_weights, uint32_t batch_size);
+void nn_train_weighted_f32(nn_network* network, float* input_data, float* target_data, float* sample_weights, uint32_t batch_size);
+
+// dest <- tau * source + (1 - tau) * dest, in place; tau = 1 copies. Same precision only
+void nn_sync(nn_network* source, nn_network* dest, double tau);
+
+void nn_randomize(nn_network* network);
+
+// See nn_params_version
+uint64_t nn_version(nn_network* network);
+
+bool nn_save(nn_network* network, const char* dirname);
+
+// See save_nn_model_async, the tickets go to checkpoint_status/wait_checkpoints below
+uint64_t nn_save_async(nn_network* network, const char* dirname);
+
+// Id-based API, a shim over handles kept in per-nn_type tables: init_nn/load_nn_model/clone_nn
+// add a network and return its id within nn_type, with nn_default_options of that type. Not
+// safe to use from several threads while networks are being added
+
 uint32_t init_nn(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim, 
     uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type);
 
 void predict_nn(uint32_t id, uint32_t nn_type, double* input_data, double* output_data, uint32_t batch_size);
 
+// One forward pass for predict_many
+typedef struct nn_predict_job {
+    uint32_t id;
+    uint32_t nn_type;
+    double* input_data;
+    double* output_data;
+    uint32_t batch_size;
+} nn_predict_job;
+
+// Runs count predict_nn calls concurrently on the library's worker threads and returns when all
+// are done. Jobs on the same network run one after another, in order
+void predict_many(const nn_predict_job* jobs, uint32_t count);
+
 void train_nn(uint32_t id, uint32_t nn_type, double* input_data, double* target_data, uint32_t batch_size);
 
+// train_nn with every sample's gradient scaled by sample_weights[i] (batch_size values)
+void train_nn_weighted(uint32_t id, uint32_t nn_type, double* input_data, double* target_data, double* sample_weights, uint32_t batch_size);
+
+// Copies the online weights/biases into the target in place
 void update_target_nn(uint32_t online_nn_id, uint32_t target_nn_id);
 
+// Polyak averaging, target <- tau * online + (1 - tau) * target, tau in (0, 1]
+void soft_update_target_nn(uint32_t online_nn_id, uint32_t target_nn_id, double tau);
+
+// New instance of nn_type holding a copy of instance id, returns its id. The copy has no loss
+// log. Instances are independent: training one while predicting with another from a
+// different thread is safe, as long as no instance is created meanwhile
+uint32_t clone_nn(uint32_t id, uint32_t nn_type);
+
+// Copy the weights/biases of src_id into dst_id (same nn_type) in place
+void copy_nn_params(uint32_t src_id, uint32_t dst_id, uint32_t nn_type);
+
+// Tag of the instance's current weights: changes whenever they do (train, randomize, load,
+// sync) and is never reused, so outputs cached under one tag stay valid while it is returned
+uint64_t nn_params_version(uint32_t id, uint32_t nn_type);
+
 bool save_nn_model(uint32_t id, uint32_t nn_type, const char* dirname);
 
 uint32_t load_nn_model(const char* dirname, uint32_t nn_type);
 
+// Background checkpointing: the parameters are copied right away and written by a writer
+// thread. Returns a ticket (0 if nothing could be queued) for checkpoint_status, which gives
+// -1 failed, 0 pending, 1 done, 2 unknown/already collected. wait_checkpoints blocks until
+// every queued save is on disk and returns the number of failures since its last call
+uint64_t save_nn_model_async(uint32_t id, uint32_t nn_type, const char* dirname);
+
+int32_t checkpoint_status(uint64_t ticket);
+
+uint32_t wait_checkpoints();
+
 uint32_t randomize_weights(uint32_t id, uint32_t nn_type);
 
+// float32 networks. Same ids/nn_types as above, but a separate set of instances.
+// load_nn_model_f32 also loads models saved as double (and load_nn_model float ones)
+
+uint32_t init_nn_f32(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim, 
+    uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type);
+
+void predict_nn_f32(uint32_t id, uint32_t nn_type, float* input_data, float* output_data, uint32_t batch_size);
+
+typedef struct nn_predict_job_f32 {
+    uint32_t id;
+    uint32_t nn_type;
+    float* input_data;
+    float* output_data;
+    uint32_t batch_size;
+} nn_predict_job_f32;
+
+void predict_many_f32(const nn_predict_job_f32* jobs, uint32_t count);
+
+void train_nn_f32(uint32_t id, uint32_t nn_type, float* input_data, float* target_data, uint32_t batch_size);
+
+void train_nn_weighted_f32(uint32_t id, uint32_t nn_type, float* input_data, float* target_data, float* sample_weights, uint32_t batch_size);
+
+void update_target_nn_f32(uint32_t online_nn_id, uint32_t target_nn_id);
+
+void soft_update_target_nn_f32(uint32_t online_nn_id, uint32_t target_nn_id, double tau);
+
+uint32_t clone_nn_f32(uint32_t id, uint32_t nn_type);
+
+void copy_nn_params_f32(uint32_t src_id, uint32_t dst_id, uint32_t nn_type);
+
+uint64_t nn_params_version_f32(uint32_t id, uint32_t nn_type);
+
+bool save_nn_model_f32(uint32_t id, uint32_t nn_type, const char* dirname);
+
+uint32_t load_nn_model_f32(const char* dirname, uint32_t nn_type);
+
+uint64_t save_nn_model_async_f32(uint32_t id, uint32_t nn_type, const char* dirname);
+
+uint32_t randomize_weights_f32(uint32_t id, uint32_t nn_type);
+
 #ifdef __cplusplus
 }                           // End extern "C" block
-#endif
\ No newline at end of file
+#endif
+
+#endif
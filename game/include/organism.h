@@ -1,6 +1,8 @@
 #ifndef ORGANISM_H
 #define ORGANISM_H
+#ifndef HEADLESS
 #include <SDL.h>
+#endif
 #include <iostream>
 #include <sprites.h>
 
@@ -50,7 +52,9 @@ class Organism : public Sprite {
         
         bool move(int dx, int dy);
 
+#ifndef HEADLESS
         void draw(SDL_Renderer* renderer) override;
+#endif
 
         void eat();
 
@@ -62,8 +66,6 @@ class Organism : public Sprite {
 
         uint32_t getEnergy() const { return energy_lvl; }
 
-        uint32_t getSector(int width, int height);
-
         uint32_t foodCount() const { return foods_eaten; }
 
 };
@@ -19,10 +19,14 @@ class EpsilonGreedyPolicy {
         std::mt19937 rng;
         std::uniform_real_distribution<double> unif;
 
+        // reused for every greedy step so action selection does not allocate
+        std::vector<double> m_input_data;
+        double m_q_values[4];
+
     public:
         EpsilonGreedyPolicy(double epsilon = 1.0, double decay_rate = 0.99, double min_epsilon = 0.01);
         
-        Action selectAction(uint32_t id, uint32_t nn_type, State state);
+        Action selectAction(nn_network* network, State state);
 };
 
 class BoltzmannPolicy {
@@ -38,6 +42,13 @@ private:
 
     int selectAction(const std::vector<double>& q_values);
 
+    // softmax of the 4 q_values at the current temperature into probs
+    void computeProbabilities(const double* q_values, double* probs);
+
+    // reused for every step so action selection does not allocate
+    std::vector<double> m_input_data;
+    double m_q_values[4];
+
 public:
     BoltzmannPolicy(double initial_temp = 1.0, 
                     double decay_rate = 0.9995,
@@ -58,11 +69,20 @@ public:
 
     int selectAction(double* q_values);
 
-    Action selectAction(uint32_t id, uint32_t nn_type, State state);
+    Action selectAction(nn_network* network, State state);
+
+    // Sample an action from Q-values that were already predicted (e.g. one row of a batched
+    // prediction) and decay the temperature
+    Action chooseAction(double* q_values);
 
     void decayTemperature();
 
-    double getTemperature();
+    double getTemperature() const;
+
+    int getDecayCounter() const { return m_decay_counter; }
+
+    // Continue a saved run's temperature schedule
+    void restoreState(double temperature, int decay_counter);
 };
 
 #endif // POLICY_H
\ No newline at end of file
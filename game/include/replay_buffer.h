@@ -0,0 +1,121 @@
+#ifndef REPLAY_BUFFER_H
+#define REPLAY_BUFFER_H
+
+#include <vector>
+#include <random>
+#include <iosfwd>
+#include <cstddef>
+#include <cstdint>
+#include <sum_tree.h>
+
+// Fixed-capacity ring of already-encoded network inputs, stored struct-of-arrays: one flat
+// row-major array per field, all allocated up front. Inserting is O(1) and overwrites the
+// oldest entry once full, and a sampled batch is a gather of rows from flat memory.
+//
+// The DQN buffer stores full transitions (state, next state, action, reward, done). The RND
+// buffer only needs states and is created with transitions = false, leaving the other
+// arrays empty.
+//
+// In prioritized mode every slot also has a priority (|TD error| + eps)^alpha in a sum-tree,
+// new transitions get the highest priority seen so far so they are replayed at least once.
+//
+// With embeddings enabled every slot also holds the output of a frozen network for its state
+// (the RND target), filled in by the owner. The newest pendingEmbeddings() slots, starting at
+// pendingStart() and wrapping around, don't have theirs yet. All embeddings carry one version
+// tag, the parameter version of the network they came from.
+class ReplayBuffer {
+    private:
+        size_t m_capacity = 0;
+        size_t m_state_dim = 0;
+        size_t m_size = 0;
+        size_t m_head = 0; // slot the next push() writes to
+
+        std::vector<double> m_states;      // capacity x state_dim
+        std::vector<double> m_next_states; // capacity x state_dim
+        std::vector<int> m_actions;
+        std::vector<double> m_rewards;
+        std::vector<double> m_dones;       // 1.0 if the episode ended on this transition
+
+        bool m_transitions = false;
+
+        bool m_prioritized = false;
+        double m_alpha = 0.0;
+        double m_priority_eps = 0.0;
+        double m_max_priority = 1.0;
+        SumTree m_priorities;
+
+        size_t m_embedding_dim = 0;
+        std::vector<double> m_embeddings; // capacity x embedding_dim
+        size_t m_pending_embeddings = 0;
+        uint64_t m_embedding_version = 0;
+
+    public:
+        ReplayBuffer() = default;
+
+        ReplayBuffer(size_t capacity, size_t state_dim, bool transitions = true);
+
+        // Turn on prioritized replay, must be called while the buffer is still empty
+        void enablePrioritized(double alpha, double priority_eps);
+
+        bool isPrioritized() const { return m_prioritized; }
+
+        // Allocate an embedding row per slot, must be called while the buffer is still empty
+        void enableEmbeddings(size_t embedding_dim);
+
+        double* embedding(size_t slot) { return &m_embeddings[slot * m_embedding_dim]; }
+
+        size_t pendingEmbeddings() const { return m_pending_embeddings; }
+        size_t pendingStart() const { return (m_head + m_capacity - m_pending_embeddings) % m_capacity; }
+
+        // The oldest count pending slots got their embeddings
+        void markEmbedded(size_t count);
+
+        // Embeddings of another version are stale: every filled slot becomes pending
+        uint64_t embeddingVersion() const { return m_embedding_version; }
+        void setEmbeddingVersion(uint64_t version);
+
+        // Claim the next slot (the oldest entry once the buffer is full) and return its index.
+        // The caller encodes straight into state(slot)/nextState(slot)
+        size_t push();
+
+        double* state(size_t slot) { return &m_states[slot * m_state_dim]; }
+        const double* state(size_t slot) const { return &m_states[slot * m_state_dim]; }
+
+        double* nextState(size_t slot) { return &m_next_states[slot * m_state_dim]; }
+        const double* nextState(size_t slot) const { return &m_next_states[slot * m_state_dim]; }
+
+        void setTransition(size_t slot, int action, double reward, bool done);
+
+        int action(size_t slot) const { return m_actions[slot]; }
+        double reward(size_t slot) const { return m_rewards[slot]; }
+        double done(size_t slot) const { return m_dones[slot]; }
+
+        // batch_size uniform random slots (with replacement) out of the filled part
+        void sample(size_t batch_size, std::mt19937& gen, std::vector<size_t>& slots) const;
+
+        // batch_size slots drawn proportionally to priority (one per equal slice of the total,
+        // stratified) and their importance-sampling weights (p / p_min)^-beta, at most 1
+        void samplePrioritized(size_t batch_size, std::mt19937& gen, double beta,
+                               std::vector<size_t>& slots, std::vector<double>& weights) const;
+
+        // New priorities from the absolute TD errors of a trained batch
+        void updatePriorities(const std::vector<size_t>& slots, const std::vector<double>& td_errors);
+
+        // Copy the state/next state rows of slots into out, one row per slot
+        void gatherStates(const std::vector<size_t>& slots, double* out) const;
+        void gatherNextStates(const std::vector<size_t>& slots, double* out) const;
+        void gatherEmbeddings(const std::vector<size_t>& slots, double* out) const;
+
+        // Stream the filled part of the buffer (and its priorities) out / back in, one bulk
+        // write per array. read() needs a buffer of the same capacity and state dimension and
+        // leaves it empty if the stream does not match; both throw on I/O errors. Embeddings are
+        // not streamed, they are all pending after read()
+        void write(std::ostream& out) const;
+        void read(std::istream& in);
+
+        size_t size() const { return m_size; }
+        size_t capacity() const { return m_capacity; }
+        size_t stateDim() const { return m_state_dim; }
+};
+
+#endif
@@ -10,6 +10,8 @@
 #include <nn_api.h>
 #include <cmath>
 #include <io_frontend.h>
+#include <config.h>
+#include <stats.h>
 
 #define MAX_ENERGY 100.0f
 /*
@@ -33,15 +35,31 @@
 
 #define REPLAY_BUFFER_CAPACITY 10000 // Capacity for RND replay buffer*/
 
+// nn_type of each network, picks its hyperparameters
 #define DQN_ONLINE_ID 0 // ID for DQN online
 #define DQN_TARGET_ID 1 // ID for DQN target
 
 #define RND_PREDICTOR_ID 2 // ID for RND predictor
 #define RND_TARGET_ID 3 // ID for RND target
 
-extern IO_FRONTEND::DQN_Params dqn_parameters;
-extern IO_FRONTEND::RND_Params rnd_parameters;
-extern IO_FRONTEND::BoltzmannPolicy_Params boltzmann_parameters;
+// Networks the acting side (action selection, intrinsic reward) predicts with, owned by a
+// Trainer: its trained networks themselves, unless the async learner gave the actor copies
+struct ActorNetworks {
+    nn_network* dqn_online = nullptr;
+    nn_network* rnd_predictor = nullptr;
+    nn_network* rnd_target = nullptr;
+};
+
+// What the per-step intrinsic reward reads and updates, all of it one trainer's: its actor
+// networks, its novelty statistics and scratch buffers for the RND input (RND_INPUT_DIM) and
+// the predictor/target outputs (RND_OUTPUT_DIM each), so a step allocates nothing
+struct IntrinsicRewardContext {
+    const ActorNetworks* networks;
+    stats::Normalizer* stats;
+    double* input;
+    double* pred_out;
+    double* targ_out;
+};
 
 inline double tanh_scale(double x, double amplitude, double sensitivity) {
     if (sensitivity <= 0.0) sensitivity = 1.0;
@@ -74,30 +92,23 @@ enum class PolicyType {
     BOLTZMANN
 };
 
-class RND_replay_buffer {
-    private:
-        std::vector<std::vector<double>> buffer;
-        size_t capacity;
-        size_t size;
-        std::mt19937 m_gen;
-        IO_FRONTEND::RND_Params m_rnd_parameters;
-
-    public:
-        // Constructor
-        RND_replay_buffer(size_t capacity, IO_FRONTEND::RND_Params rnd_parameters);
-
-        // Member functions
-        void add(double* value);
-        double* get_batch(size_t batch_size);
-        size_t current_size() const;
-};
+// Relative RMSE between the RND predictor and target outputs of one state
+double rndNoveltyMetric(const double* pred_out, const double* targ_out, int output_dim);
 
-double computeIntrinsicReward(double* input_data);
+// z-score of the novelty of the RND input in rnd.input, which also enters rnd.stats
+double computeIntrinsicReward(const IntrinsicRewardContext& rnd);
 
 double computeExtrinsicReward(State state, Action action, bool hit_wall, int org_x, int org_y, Direction dir, int wall_pos_x = -1, int wall_pos_y = -1);
 
-double computeReward(State state, Action action, std::vector<double> food_rates, uint32_t organism_sector, bool enable_rnd, bool hit_wall, int org_x, int org_y, Direction dir, int wall_pos_x = -1, int wall_pos_y = -1);
+double computeReward(State state, Action action, std::vector<double> food_rates, uint32_t organism_sector, bool enable_rnd,
+    const IntrinsicRewardContext& rnd, bool hit_wall, int org_x, int org_y, Direction dir, int wall_pos_x = -1, int wall_pos_y = -1);
 
 double* prepareInputData(State state, bool is_RND, std::vector<double> food_rates, uint32_t organism_sector);
 
+// Encode the DQN input for state into input_data (DQN_INPUT_DIM values), no allocation
+void prepareInputData(const State& state, double* input_data);
+
+// Encode the RND input into input_data (2 + food_rates.size() values), no allocation
+void prepareRNDInputData(const State& state, const std::vector<double>& food_rates, uint32_t organism_sector, double* input_data);
+
 #endif // RL_UTILS_H
\ No newline at end of file
@@ -1,7 +1,9 @@
 #ifndef SPRITES_H
 #define SPRITES_H
 
+#ifndef HEADLESS
 #include <SDL.h>
+#endif
 #include <iostream>
 
 enum Color {
@@ -23,7 +25,9 @@ enum Direction {
     RIGHT=3
 };
 
+#ifndef HEADLESS
 void drawCircle(SDL_Renderer* renderer, int x_c, int y_c, int r, bool filled);
+#endif
 
 class Sprite {
     protected:
@@ -46,7 +50,9 @@ class Sprite {
 
         virtual bool move(int dx, int dy) = 0;
 
+#ifndef HEADLESS
         virtual void draw(SDL_Renderer* renderer) = 0;
+#endif
 
         void setPosition(int newX, int newY);
 
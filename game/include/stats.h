@@ -4,13 +4,10 @@
 #include <cstddef>  // for std::size_t
 #include <cmath>    // for std::sqrt
 #include <algorithm> // for std::min
+#include <iostream>
 
 namespace stats {
 
-inline size_t n    = 0;
-inline double mu   = 0.0;
-inline double m2   = 0.0;
-
 // New constant for the EMA smoothing factor
 inline constexpr double EMA_ALPHA = 0.1; // A value between 0.0 and 1.0. Lower values for slower decay.
 
@@ -20,45 +17,70 @@ inline constexpr double beta_floor = 0.01;
 inline constexpr double beta_decay_lambda = 0.1;
 inline constexpr std::size_t beta_decay_steps = 20000000000ULL;
 
-inline double current_beta(int food_count) {
-    double frac = std::min(1.0, double(n) / beta_decay_steps);
-    double exponential_decay_term = std::exp(-beta_decay_lambda * frac);
-    return beta_floor + (beta_init - beta_floor) * exponential_decay_term;
-}
+// Running statistics of the RND novelty metric. Each Trainer owns one, so trainers in the
+// same process normalize their intrinsic rewards independently
+struct Normalizer {
+    size_t n    = 0;
+    double mu   = 0.0;
+    double m2   = 0.0;
 
-inline double peek_z_score(double x) {
-    // if x is NaN or infinite, return 0.0
-    if (std::isnan(x) || std::isinf(x)) {
-        // print an error message
-        std::cerr << "Error: NaN or infinite value encountered in peek_z_score." << std::endl;
-        // print x
-        std::cerr << "Value: " << x << std::endl;
-        exit(1);
+    double current_beta(int food_count) const {
+        double frac = std::min(1.0, double(n) / beta_decay_steps);
+        double exponential_decay_term = std::exp(-beta_decay_lambda * frac);
+        return beta_floor + (beta_init - beta_floor) * exponential_decay_term;
     }
-    if (n < 2) {
-        return 0.0;
+
+    double peek_z_score(double x) const {
+        // if x is NaN or infinite, return 0.0
+        if (std::isnan(x) || std::isinf(x)) {
+            // print an error message
+            std::cerr << "Error: NaN or infinite value encountered in peek_z_score." << std::endl;
+            // print x
+            std::cerr << "Value: " << x << std::endl;
+            exit(1);
+        }
+        if (n < 2) {
+            return 0.0;
+        }
+        double sigma = std::sqrt(m2); // Note: we use m2 directly for EMA variance
+        constexpr double eps = 1e-8;
+        return (x - mu) / (sigma + eps);
     }
-    double sigma = std::sqrt(m2); // Note: we use m2 directly for EMA variance
-    constexpr double eps = 1e-8;
-    return (x - mu) / (sigma + eps);
-}
 
-inline void update_stats(double x) {
-    ++n;
-    if (n <= 1) {
-        // Initialize mu and m2 with the first value
-        mu = x;
-        m2 = 0.0;
-    } else {
-        // Calculate the EMA of the mean (mu)
-        double delta1 = x - mu;
-        mu    += delta1 * EMA_ALPHA;
+    void update_stats(double x) {
+        ++n;
+        if (n <= 1) {
+            // Initialize mu and m2 with the first value
+            mu = x;
+            m2 = 0.0;
+        } else {
+            // Calculate the EMA of the mean (mu)
+            double delta1 = x - mu;
+            mu    += delta1 * EMA_ALPHA;
+
+            // Calculate the EMA of the variance (m2)
+            double delta2 = x - mu;
+            m2    = (1 - EMA_ALPHA) * (m2 + delta1 * delta2);
+        }
+    }
 
-        // Calculate the EMA of the variance (m2)
-        double delta2 = x - mu;
-        m2    = (1 - EMA_ALPHA) * (m2 + delta1 * delta2);
+    // One EMA step for a whole batch of values with the given mean and variance: the batch moves mu
+    // like a single observation at its mean, its spread goes into m2. A replayed batch repeats
+    // transitions that were counted before, so n only advances by new_samples, the transitions
+    // stored since the last update. current_beta then decays per env step like with update_stats
+    void update_stats_batch(double batch_mean, double batch_var, size_t new_samples) {
+        bool first = (n == 0);
+        n += new_samples;
+        if (first) {
+            mu = batch_mean;
+            m2 = batch_var;
+            return;
+        }
+        double delta = batch_mean - mu;
+        mu += delta * EMA_ALPHA;
+        m2  = (1 - EMA_ALPHA) * (m2 + EMA_ALPHA * delta * delta) + EMA_ALPHA * batch_var;
     }
-}
+};
 
 } // namespace stats
 
@@ -0,0 +1,33 @@
+#ifndef SUM_TREE_H
+#define SUM_TREE_H
+
+#include <vector>
+#include <cstddef>
+
+// Binary segment tree over a fixed number of leaves keeping both the sum and the minimum of
+// every subtree. Used by prioritized replay: update() and find() are O(log N), total() and
+// min() are O(1). Node 1 is the root, leaves start at index m_leaves.
+class SumTree {
+    private:
+        size_t m_leaves = 0; // capacity rounded up to a power of two
+        std::vector<double> m_sums;
+        std::vector<double> m_mins; // unused leaves hold +inf so they never become the minimum
+
+    public:
+        SumTree() = default;
+
+        explicit SumTree(size_t capacity);
+
+        void update(size_t leaf, double priority);
+
+        double get(size_t leaf) const { return m_sums[m_leaves + leaf]; }
+
+        double total() const { return m_sums[1]; }
+
+        double min() const { return m_mins[1]; }
+
+        // Leaf whose cumulative priority range contains prefix, for prefix in [0, total())
+        size_t find(double prefix) const;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef TRANSITION_QUEUE_H
+#define TRANSITION_QUEUE_H
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Lock-free single-producer/single-consumer ring carrying already-encoded transitions from
+// the actor (env loop) to the learner thread. Storage is struct-of-arrays like ReplayBuffer
+// and allocated once; the producer encodes straight into a claimed slot and publishes it
+// with one release store, the consumer copies it into the replay buffers and frees it.
+//
+// Each slot holds the DQN state and next state rows, action, reward, done and the RND
+// input row of the transition.
+class TransitionQueue {
+    private:
+        size_t m_capacity; // power of two
+        size_t m_mask;
+        size_t m_state_dim;
+        size_t m_rnd_dim;
+
+        std::vector<double> m_states;
+        std::vector<double> m_next_states;
+        std::vector<double> m_rnd_inputs;
+        std::vector<int> m_actions;
+        std::vector<double> m_rewards;
+        std::vector<uint8_t> m_dones;
+
+        // monotonically increasing counters, slot = counter & m_mask. Each on its own cache
+        // line so producer and consumer don't bounce it between cores
+        alignas(64) std::atomic<size_t> m_head{0}; // next slot to read, written by the consumer
+        alignas(64) std::atomic<size_t> m_tail{0}; // next slot to write, written by the producer
+        alignas(64) size_t m_cached_head = 0;      // producer's last look at m_head
+
+    public:
+        // capacity is rounded up to a power of two
+        TransitionQueue(size_t capacity, size_t state_dim, size_t rnd_dim);
+
+        TransitionQueue(const TransitionQueue&) = delete;
+        TransitionQueue& operator=(const TransitionQueue&) = delete;
+
+        // Producer: slot to encode the next transition into, false if the queue is full
+        bool claim(size_t& slot);
+        // Producer: make the claimed slot visible to the consumer
+        void publish();
+
+        // Consumer: oldest published slot, false if the queue is empty
+        bool front(size_t& slot) const;
+        // Consumer: release the front slot
+        void pop();
+
+        double* state(size_t slot) { return &m_states[slot * m_state_dim]; }
+        double* nextState(size_t slot) { return &m_next_states[slot * m_state_dim]; }
+        double* rndInput(size_t slot) { return &m_rnd_inputs[slot * m_rnd_dim]; }
+
+        void setTransition(size_t slot, int action, double reward, bool done) {
+            m_actions[slot] = action;
+            m_rewards[slot] = reward;
+            m_dones[slot] = done ? 1 : 0;
+        }
+
+        int action(size_t slot) const { return m_actions[slot]; }
+        double reward(size_t slot) const { return m_rewards[slot]; }
+        bool done(size_t slot) const { return m_dones[slot] != 0; }
+
+        size_t capacity() const { return m_capacity; }
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef VEC_ENV_H
+#define VEC_ENV_H
+
+#include <map.h>
+#include <organism.h>
+#include <agent.h>
+#include <policy.h>
+#include <environment.h>
+#include <vector>
+
+// N independent map + organism instances stepped in lockstep. Action selection for all
+// envs is a single batched nn_predict call on the trainer's actor DQN, and envs whose organism
+// starves are reset automatically. All envs feed the same Trainer.
+class VecEnv {
+    private:
+        std::vector<Map> m_maps;
+        std::vector<Organism> m_organisms;
+        std::vector<Agent> m_agents;
+        std::vector<Environment> m_envs;
+
+        Trainer* m_trainer = nullptr; // picks the actions through its actor networks
+
+        BoltzmannPolicy* m_boltzmann_policy;
+
+        std::vector<double> m_inputs;   // num_envs x DQN_INPUT_DIM, one encoded state per row
+        std::vector<double> m_q_values; // num_envs x DQN_OUTPUT_DIM
+
+        std::vector<int> m_finished;        // envs whose episode ended on the last step
+        std::vector<int> m_episode_lengths; // length of the last finished episode per env
+
+    public:
+        VecEnv(int num_envs, Genome genome);
+
+        ~VecEnv();
+
+        void setTrainer(Trainer* trainer);
+
+        void setPolicy(PolicyType policy_type);
+
+        void setRNDEnabled(bool enabled);
+
+        // Start a fresh episode in every env
+        void reset();
+
+        // Step every env once. Returns the indices of envs whose episode ended on this
+        // step; those envs have already been reset.
+        const std::vector<int>& step();
+
+        int size() const { return static_cast<int>(m_envs.size()); }
+
+        int getEpisodeLength(int env_id) const { return m_episode_lengths[env_id]; }
+
+        // Episode number env_id's metrics records are tagged with
+        void setEpisode(int env_id, uint32_t episode) { m_envs[env_id].setEpisode(episode); }
+
+        Agent* getAgent(int env_id) { return &m_agents[env_id]; }
+
+        Map* getMap(int env_id) { return &m_maps[env_id]; }
+
+        // Shared Boltzmann policy, nullptr until setPolicy
+        BoltzmannPolicy* getPolicy() { return m_boltzmann_policy; }
+};
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef WALL_H
 #define WALL_H
+#ifndef HEADLESS
 #include <SDL.h>
+#endif
 #include <iostream>
 
 #include <sprites.h>
@@ -16,7 +18,9 @@ class Wall : public Sprite {
 
         bool move(int dx, int dy) override;
 
+#ifndef HEADLESS
         void draw(SDL_Renderer* renderer) override;
+#endif
 };
 
 #endif
\ No newline at end of file
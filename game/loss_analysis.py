@@ -5,22 +5,36 @@ import os
 
 def parse_loss_log(file_path):
     """
-    Parses a loss log file and returns a list of loss values.
+    Parses a loss log file and returns (steps, losses, mins, maxs).
+    Lines are "<step> <loss>" (sampled) or "<step> <mean> <min> <max>" (windowed, see
+    Telemetry_specs in nn_system.params); old logs with a bare loss per line use the line
+    number as step. mins/maxs are None unless the log is windowed.
     """
-    loss_values = []
+    steps, loss_values, mins, maxs = [], [], [], []
     if not os.path.exists(file_path):
         print(f"Error: The file '{file_path}' does not exist.")
-        return []
+        return [], [], None, None
 
     with open(file_path, 'r') as f:
         for line in f:
             try:
-                # Simply try to convert the line to a float, ignoring any whitespace
-                loss_values.append(float(line.strip()))
+                cols = [float(c) for c in line.split()]
             except ValueError:
-                # If a line can't be parsed as a float, just skip it and print a warning
+                # If a line can't be parsed, just skip it and print a warning
                 print(f"Warning: Could not parse loss from line: {line.strip()}")
-    return loss_values
+                continue
+            if len(cols) == 1:
+                steps.append(len(loss_values) + 1)
+                loss_values.append(cols[0])
+            elif len(cols) >= 2:
+                steps.append(int(cols[0]))
+                loss_values.append(cols[1])
+                if len(cols) >= 4:
+                    mins.append(cols[2])
+                    maxs.append(cols[3])
+    if len(mins) != len(loss_values):
+        mins = maxs = None
+    return steps, loss_values, mins, maxs
 
 def compute_delta_and_slope(y_series, x_series):
     """
@@ -90,20 +104,26 @@ def plot_loss(file_path, plot_title, ax, start_step=0):
     """
     Parses a log file, plots the loss, and adds a trend box.
     """
-    loss_values = parse_loss_log(file_path)
+    steps, loss_values, mins, maxs = parse_loss_log(file_path)
     print(f"Parsed {len(loss_values)} loss values from {file_path}")
     
-    # Slice the data to start from the specified step
+    # Keep only the data from the specified step on
     if start_step > 0:
-        loss_values = loss_values[start_step - 1:]
+        keep = [i for i, s in enumerate(steps) if s >= start_step]
+        steps = [steps[i] for i in keep]
+        loss_values = [loss_values[i] for i in keep]
+        if mins is not None:
+            mins = [mins[i] for i in keep]
+            maxs = [maxs[i] for i in keep]
     
     if not loss_values:
         ax.text(0.5, 0.5, 'No data to plot', ha='center', va='center', fontsize=12)
         ax.set_title(plot_title)
         return
 
-    steps = list(range(start_step, start_step + len(loss_values)))
     ax.plot(steps, loss_values, label='Loss')
+    if mins is not None:
+        ax.fill_between(steps, mins, maxs, alpha=0.25, label='min/max')
 
     # Compute and plot trend
     trend_tuple = compute_delta_and_slope(loss_values, steps)
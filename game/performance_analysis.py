@@ -76,8 +76,76 @@ def parse_system_log(file_path):
     return episodes
 
 
-def plot_dqn_diagnostics(episodes, ma_window=50):
-    # Episode-level aggregates
+# Layout of metrics.bin (game/include/metrics.h): 16 byte header, then fixed-width records
+METRICS_VERSION = 1
+METRICS_HEADER = np.dtype([('magic', 'S8'), ('version', '<u4'), ('record_size', '<u4')])
+METRICS_DTYPE = np.dtype([
+    ('episode', '<u4'), ('step', '<u4'), ('env', '<u2'), ('action', 'u1'), ('reserved', 'u1'),
+    ('q_values', '<f4', (4,)), ('temperature', '<f4'), ('energy', '<f4'),
+    ('extrinsic_reward', '<f4'), ('total_reward', '<f4'), ('beta', '<f4'),
+    ('z_score', '<f4'), ('intrinsic_mse', '<f4'),
+])
+METRICS_INDEX_DTYPE = np.dtype([('episode', '<u4'), ('length', '<u4'), ('first_record', '<u8'), ('end_record', '<u8')])
+
+
+def _read_metrics_array(path, magic, dtype):
+    header = np.fromfile(path, dtype=METRICS_HEADER, count=1)
+    if header.size == 0 or header['magic'][0] != magic:
+        raise ValueError(f"{path} is not a metrics file")
+    if header['version'][0] != METRICS_VERSION or header['record_size'][0] != dtype.itemsize:
+        raise ValueError(f"{path}: unsupported version {header['version'][0]} / record size {header['record_size'][0]}")
+    return np.memmap(path, dtype=dtype, mode='r', offset=METRICS_HEADER.itemsize)
+
+
+def load_metrics(path='metrics.bin'):
+    """Per-step records as a numpy structured array (memory-mapped) and the episode index.
+    Fields that were not produced on a step (RND terms with RND off) are NaN."""
+    records = _read_metrics_array(path, b'LIFEMET', METRICS_DTYPE)
+    index = _read_metrics_array(path + '.idx', b'LIFEIDX', METRICS_INDEX_DTYPE)
+    return records, index
+
+
+def aggregate_metrics(records, index):
+    # Finished episodes only, in index order; per-episode sums/means via bincount on the episode column
+    episode_nums = np.asarray(index['episode'], dtype=np.int64)
+    ep_col = np.asarray(records['episode'], dtype=np.int64)
+    size = int(max(ep_col.max(initial=0), episode_nums.max(initial=0))) + 1
+
+    def per_episode_sum(values):
+        values = np.asarray(values, dtype=np.float64)
+        mask = np.isfinite(values)
+        sums = np.bincount(ep_col[mask], weights=values[mask], minlength=size)
+        counts = np.bincount(ep_col[mask], minlength=size)
+        return sums[episode_nums], counts[episode_nums]
+
+    def per_episode_mean(values):
+        sums, counts = per_episode_sum(values)
+        with np.errstate(invalid='ignore', divide='ignore'):
+            return np.where(counts > 0, sums / np.maximum(counts, 1), np.nan)
+
+    extrinsic, _ = per_episode_sum(records['extrinsic_reward'])
+    total, _ = per_episode_sum(records['total_reward'])
+    lengths = np.bincount(ep_col, minlength=size)[episode_nums]
+    intrinsic_terms, _ = per_episode_sum(np.asarray(records['beta'], dtype=np.float64) * records['z_score'])
+
+    with np.errstate(invalid='ignore', divide='ignore'):
+        avg_extrinsic_per_step = np.where(lengths > 0, extrinsic / np.maximum(lengths, 1), np.nan)
+
+    return {
+        'episode_nums': episode_nums.tolist(),
+        'extrinsic_rewards': extrinsic.tolist(),
+        'total_rewards': total.tolist(),
+        'lengths': lengths.tolist(),
+        'avg_z': per_episode_mean(records['z_score']).tolist(),
+        'avg_intrinsic': per_episode_mean(records['intrinsic_mse']).tolist(),
+        'avg_beta': per_episode_mean(records['beta']).tolist(),
+        'avg_extrinsic_per_step': avg_extrinsic_per_step.tolist(),
+        'total_intrinsic_rewards': intrinsic_terms.tolist(),
+    }
+
+
+def aggregate_log_episodes(episodes):
+    # Same aggregates from the records of parse_system_log (text trace, LOG_MIN_LEVEL=0 builds)
     episode_nums      = [ep['episode'] for ep in episodes]
     extrinsic_rewards = [sum(r.get('extrinsic_reward', 0) for r in ep['records']) for ep in episodes]
     total_rewards     = [sum(r.get('total_reward',   0) for r in ep['records']) for ep in episodes]
@@ -100,6 +168,31 @@ def plot_dqn_diagnostics(episodes, ma_window=50):
     avg_extrinsic_per_step = [extrinsic_rewards[i] / lengths[i] if lengths[i] > 0 else np.nan for i in range(len(extrinsic_rewards))]
     total_intrinsic_rewards = [sum(r.get('beta', 0) * r.get('z_score', 0) for r in ep['records']) for ep in episodes]
 
+    return {
+        'episode_nums': episode_nums,
+        'extrinsic_rewards': extrinsic_rewards,
+        'total_rewards': total_rewards,
+        'lengths': lengths,
+        'avg_z': avg_z,
+        'avg_intrinsic': avg_intrinsic,
+        'avg_beta': avg_beta,
+        'avg_extrinsic_per_step': avg_extrinsic_per_step,
+        'total_intrinsic_rewards': total_intrinsic_rewards,
+    }
+
+
+def plot_dqn_diagnostics(agg, ma_window=50):
+    # Episode-level aggregates (aggregate_metrics / aggregate_log_episodes)
+    episode_nums            = agg['episode_nums']
+    extrinsic_rewards       = agg['extrinsic_rewards']
+    total_rewards           = agg['total_rewards']
+    lengths                 = agg['lengths']
+    avg_z                   = agg['avg_z']
+    avg_intrinsic           = agg['avg_intrinsic']
+    avg_beta                = agg['avg_beta']
+    avg_extrinsic_per_step  = agg['avg_extrinsic_per_step']
+    total_intrinsic_rewards = agg['total_intrinsic_rewards']
+
     # moving average for extrinsic (if desired)
     window = min(ma_window, len(extrinsic_rewards))
     if window > 1:
@@ -339,5 +432,11 @@ def plot_dqn_diagnostics(episodes, ma_window=50):
 
 
 if __name__ == '__main__':
-    episodes = parse_system_log('system.log')
-    plot_dqn_diagnostics(episodes)
+    import os
+    if os.path.exists('metrics.bin'):
+        records, index = load_metrics('metrics.bin')
+        plot_dqn_diagnostics(aggregate_metrics(records, index))
+    else:
+        # runs without metrics.bin: fall back to the DEBUG text trace
+        episodes = parse_system_log('system.log')
+        plot_dqn_diagnostics(aggregate_log_episodes(episodes))
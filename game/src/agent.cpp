@@ -6,12 +6,11 @@
 #include <iomanip>
 #include <algorithm>
 #include <logger.h>
+#include <fstream>
+#include <cstring>
+#include <chrono>
 
-#define RND_DIRECTORY "/models/rnd_model"
 
-IO_FRONTEND::RND_Params rnd_parameters;
-IO_FRONTEND::DQN_Params dqn_parameters;
-IO_FRONTEND::BoltzmannPolicy_Params boltzmann_parameters;
 
 Agent::Agent(Organism* organism):
     m_organism(organism) {  // Dynamically allocate
@@ -26,12 +25,19 @@ Agent::Agent(Organism* organism):
     m_boltzmann_policy = nullptr;
 }
 
-void Agent::setPolicy(PolicyType policy_type) {
+Agent::Agent(Agent&& other) noexcept :
+    m_organism(other.m_organism),
+    m_state(other.m_state),
+    m_action(other.m_action),
+    m_boltzmann_policy(other.m_boltzmann_policy),
+    m_policy_type(other.m_policy_type) {
 
-    int status = parse_boltzmann_params("../game/rl_system.params", boltzmann_parameters);
+    other.m_boltzmann_policy = nullptr;
+}
 
-    if (status == false) {
-        std::cerr << "Error parsing Boltzmann parameters for frontend" << std::endl;
+void Agent::setPolicy(PolicyType policy_type) {
+
+    if (!config::load()) {
         exit(1);
     }
 
@@ -76,202 +82,299 @@ void Agent::updateState(Map* map, bool is_eating) {
     m_state.food_count = m_organism->foodCount();
 }
 
-Action Agent::chooseAction() {
+Action Agent::chooseAction(nn_network* network) {
     switch (m_policy_type) {
         case PolicyType::EPSILON_GREEDY:
             //return m_epsilon_policy->selectAction(0, 0, m_state);
         case PolicyType::BOLTZMANN:
-            return m_boltzmann_policy->selectAction(0, DQN_ONLINE_ID, m_state);
+            return m_boltzmann_policy->selectAction(network, m_state);
         default:
             throw std::invalid_argument("Unknown policy type");
     }
 }
 
-RND_replay_buffer createRNDReplayBuffer(int buffer_size) {
-    // 1. Parse the RND parameters here
-    bool status = IO_FRONTEND::parse_rnd_params("../game/rl_system.params", rnd_parameters);
-    if (!status) {
-        throw std::runtime_error("Failed to parse RND parameters.");
-    }
-    
-    // 2. Now that rnd_parameters is populated, return a new RND_replay_buffer
-    // The `this->` is important to access the member variable and prevent a stack variable being created.
-    return RND_replay_buffer(buffer_size, rnd_parameters);
-}
-
 Trainer::Trainer(Agent* agent, Map* map, double discount_factor, double learning_rate, std::string model_path, int buffer_size, bool enable_rnd):
     m_agent(agent),
     m_map(map),
+    m_model_path(model_path),
     m_discount_factor(discount_factor),
     m_learning_rate(learning_rate),
     replay_buffer_size(buffer_size),
     learning_counter(0),
     m_rnd_counter(0),
-    m_rnd_replay_buffer(createRNDReplayBuffer(buffer_size)),
     m_rndEnabled(enable_rnd) {
 
-    parse_nn_params(); // parse the hyperparams used in the nn backend
-
-    int status = parse_rnd_params("../game/rl_system.params", rnd_parameters);
-    
-    if (status == false) {
-        std::cerr << "Error parsing RND parameters for frontend" << std::endl;
+    // nn and frontend params, parsed once for the whole process
+    if (!config::load()) {
         exit(1);
     }
 
-    status = parse_dqn_params("../game/rl_system.params", dqn_parameters);
     batch_size = dqn_parameters.DQN_BATCH_SIZE;
 
-    if (status == false) {
-        std::cerr << "Error parsing DQN parameters for frontend" << std::endl;
+    if (2 + FOOD_SECTORS_X * FOOD_SECTORS_Y > rnd_parameters.RND_INPUT_DIM) {
+        std::cerr << "Error: RND_INPUT_DIM is too small for " << FOOD_SECTORS_X * FOOD_SECTORS_Y << " food sectors" << std::endl;
         exit(1);
     }
 
+    // Both buffers are allocated in full here, nothing is allocated per transition
+    m_replay_buffer = ReplayBuffer(buffer_size, dqn_parameters.DQN_INPUT_DIM);
+    m_rnd_replay_buffer = ReplayBuffer(buffer_size, rnd_parameters.RND_INPUT_DIM, false);
+    m_rnd_replay_buffer.enableEmbeddings(rnd_parameters.RND_OUTPUT_DIM);
+
+    if (per_parameters.PRIORITIZED_REPLAY) {
+        m_replay_buffer.enablePrioritized(per_parameters.PER_ALPHA, per_parameters.PER_EPS);
+        std::cout << "Prioritized replay enabled (alpha " << per_parameters.PER_ALPHA << ")" << std::endl;
+    }
+
+    m_states_batch.resize(batch_size * dqn_parameters.DQN_INPUT_DIM);
+    m_next_states_batch.resize(batch_size * dqn_parameters.DQN_INPUT_DIM);
+    m_q_next_target.resize(batch_size * dqn_parameters.DQN_OUTPUT_DIM);
+    m_target_values.resize(batch_size * dqn_parameters.DQN_OUTPUT_DIM);
+    m_rnd_input_batch.resize(rnd_parameters.RND_BATCH_SIZE * rnd_parameters.RND_INPUT_DIM);
+    m_rnd_target_batch.resize(rnd_parameters.RND_BATCH_SIZE * rnd_parameters.RND_OUTPUT_DIM);
+    m_batch_rnd_inputs.resize(batch_size * rnd_parameters.RND_INPUT_DIM);
+    m_batch_rnd_pred.resize(batch_size * rnd_parameters.RND_OUTPUT_DIM);
+    m_batch_rnd_target.resize(batch_size * rnd_parameters.RND_OUTPUT_DIM);
+    m_batch_intrinsic.resize(batch_size, 0.0);
+    m_step_rnd_input.resize(rnd_parameters.RND_INPUT_DIM);
+    m_step_rnd_pred.resize(rnd_parameters.RND_OUTPUT_DIM);
+    m_step_rnd_target.resize(rnd_parameters.RND_OUTPUT_DIM);
+
+    m_batch_slots.reserve(std::max(batch_size, rnd_parameters.RND_BATCH_SIZE));
+    m_batch_weights.reserve(batch_size);
+    m_td_errors.resize(batch_size);
+
     std::random_device rd;
     m_gen = std::mt19937(rd());
+    const nn_options dqn_options = nn_default_options(DQN_ONLINE_ID);
+    const nn_options rnd_options = nn_default_options(RND_PREDICTOR_ID);
+
     // if model path does not exist, create directory and init nn
     if (!std::filesystem::exists(model_path) || model_path == "") {
         std::filesystem::create_directories(model_path);
         std::cout << "Creating new model directory: " << model_path << std::endl;
         // Initialize online neural network with default parameters
-        init_nn(dqn_parameters.DQN_INPUT_DIM, dqn_parameters.DQN_OUTPUT_DIM, dqn_parameters.DQN_HIDDEN_DIM, dqn_parameters.DQN_NUM_LAYERS, dqn_parameters.DQN_BATCH_SIZE, DQN_ONLINE_ID); // 4 for genome, 1 for energy level, 2 for vision (food count and is_wall)
+        m_dqn_online = nn_create(dqn_parameters.DQN_INPUT_DIM, dqn_parameters.DQN_OUTPUT_DIM, dqn_parameters.DQN_HIDDEN_DIM, dqn_parameters.DQN_NUM_LAYERS, dqn_parameters.DQN_BATCH_SIZE, DQN_ONLINE_ID, &dqn_options); // 4 for genome, 1 for energy level, 2 for vision (food count and is_wall)
     }
     else {
-        const char* model_path_cstr = model_path.c_str();
-
-        uint32_t id = load_nn_model(model_path_cstr, 0);
+        m_dqn_online = nn_load(model_path.c_str(), &dqn_options);
     }
     // Initialize target neural network
-    init_nn(dqn_parameters.DQN_INPUT_DIM, dqn_parameters.DQN_OUTPUT_DIM, dqn_parameters.DQN_HIDDEN_DIM, dqn_parameters.DQN_NUM_LAYERS, dqn_parameters.DQN_BATCH_SIZE, DQN_TARGET_ID);
-    // copy the online nn to the target nn
-    update_target_nn(0, 0); // copy the online nn to the target nn at index 0
-
-    std::string full_target_path = std::string(RND_DIRECTORY)
-                             + "/" 
-                             + model_path 
-                             + "/target";
+    m_dqn_target = nn_create(dqn_parameters.DQN_INPUT_DIM, dqn_parameters.DQN_OUTPUT_DIM, dqn_parameters.DQN_HIDDEN_DIM, dqn_parameters.DQN_NUM_LAYERS, dqn_parameters.DQN_BATCH_SIZE, DQN_TARGET_ID, &dqn_options);
+    if (m_dqn_online && m_dqn_target) {
+        nn_sync(m_dqn_online, m_dqn_target, 1.0); // copy the online nn to the target nn
+    }
 
-    std::string full_predictor_path = std::string(RND_DIRECTORY)
-                             + "/" 
-                             + model_path 
-                             + "/predictor";
+    const std::string full_target_path = RND_TARGET_PATH;
+    const std::string full_predictor_path = RND_PREDICTOR_PATH;
 
     if (!std::filesystem::exists(full_predictor_path)) {
         //print check
         std::cout << "Initializing RND predictor neural network" << std::endl;
         // Initialize RND predictor neural network
-        init_nn(rnd_parameters.RND_INPUT_DIM, rnd_parameters.RND_OUTPUT_DIM, rnd_parameters.RND_HIDDEN_DIM, rnd_parameters.RND_NUM_LAYERS, rnd_parameters.RND_BATCH_SIZE, RND_PREDICTOR_ID);
+        m_rnd_predictor = nn_create(rnd_parameters.RND_INPUT_DIM, rnd_parameters.RND_OUTPUT_DIM, rnd_parameters.RND_HIDDEN_DIM, rnd_parameters.RND_NUM_LAYERS, rnd_parameters.RND_BATCH_SIZE, RND_PREDICTOR_ID, &rnd_options);
     }
     else {
         std::cout << "Loading RND predictor neural network from: " << full_predictor_path << std::endl;
-        const char* model_path_cstr = full_predictor_path.c_str();
-        uint32_t id = load_nn_model(model_path_cstr, 2);
+        m_rnd_predictor = nn_load(full_predictor_path.c_str(), &rnd_options);
     }
 
     if (!std::filesystem::exists(full_target_path)) {
 
         // Initialize RND target neural network
-        init_nn(rnd_parameters.RND_INPUT_DIM, rnd_parameters.RND_OUTPUT_DIM, rnd_parameters.RND_HIDDEN_DIM, rnd_parameters.RND_NUM_LAYERS, rnd_parameters.RND_BATCH_SIZE, RND_TARGET_ID);
-        randomize_weights(0, 3); // Randomize weights for the target network
+        m_rnd_target = nn_create(rnd_parameters.RND_INPUT_DIM, rnd_parameters.RND_OUTPUT_DIM, rnd_parameters.RND_HIDDEN_DIM, rnd_parameters.RND_NUM_LAYERS, rnd_parameters.RND_BATCH_SIZE, RND_TARGET_ID, &rnd_options);
+        if (m_rnd_target) {
+            nn_randomize(m_rnd_target); // Randomize weights for the target network
+        }
     }
     else {
-        const char* model_path_cstr = full_target_path.c_str();
         // print check
-        std::cout << "Loading RND target neural network from: " << model_path_cstr << std::endl;
-        uint32_t id = load_nn_model(model_path_cstr, 3);
+        std::cout << "Loading RND target neural network from: " << full_target_path << std::endl;
+        m_rnd_target = nn_load(full_target_path.c_str(), &rnd_options);
     }
 
-    //exit(1);
+    if (!m_dqn_online || !m_dqn_target || !m_rnd_predictor || !m_rnd_target) {
+        std::cerr << "Error: Could not create or load the networks" << std::endl;
+        exit(1);
+    }
+
+    m_actor.dqn_online = m_dqn_online;
+    m_actor.rnd_predictor = m_rnd_predictor;
+    m_actor.rnd_target = m_rnd_target;
+
+    if (learner_parameters.ASYNC_LEARNER) {
+        startLearner();
+    }
 }
 
 Trainer::~Trainer() {
-    // Destructor
+    stopLearner();
+
+    if (m_actor.dqn_online != m_dqn_online) {
+        nn_destroy(m_actor.dqn_online);
+        nn_destroy(m_actor.rnd_predictor);
+        nn_destroy(m_actor.rnd_target);
+    }
+
+    for (nn_network* network : {m_staging_dqn, m_staging_rnd, m_dqn_online, m_dqn_target, m_rnd_predictor, m_rnd_target}) {
+        nn_destroy(network);
+    }
 }
 
 void Trainer::learn_from_batch() {
-    // Serves as the inputs for the neural network training
-    double* states_batch = new double[batch_size * dqn_parameters.DQN_INPUT_DIM];
-    double* next_states_batch = new double[batch_size * dqn_parameters.DQN_INPUT_DIM];
+    const int out_dim = dqn_parameters.DQN_OUTPUT_DIM;
+    double* states_batch = m_states_batch.data();
+    double* next_states_batch = m_next_states_batch.data();
+    double* q_next_target = m_q_next_target.data();
+    double* target_values = m_target_values.data();
+
+    // 1. Sample from the replay buffer and gather the encoded rows into the batches
+    const bool prioritized = m_replay_buffer.isPrioritized();
+    if (prioritized) {
+        // anneal the importance-sampling correction towards full (beta = 1)
+        double progress = std::min(1.0, static_cast<double>(m_learn_steps) / std::max(1, per_parameters.PER_BETA_STEPS));
+        double beta = per_parameters.PER_BETA_START + (1.0 - per_parameters.PER_BETA_START) * progress;
+        m_replay_buffer.samplePrioritized(batch_size, m_gen, beta, m_batch_slots, m_batch_weights);
+    } else {
+        m_replay_buffer.sample(batch_size, m_gen, m_batch_slots);
+    }
+    m_replay_buffer.gatherStates(m_batch_slots, states_batch);
+    m_replay_buffer.gatherNextStates(m_batch_slots, next_states_batch);
+
+    const bool deferred_rnd = m_rndEnabled && rnd_parameters.RND_DEFERRED;
+
+    // 2. Q(s', ·) from the target network and Q(s, ·) from the online network, the base we
+    // edit in-place, plus the RND predictor on the batch's RND inputs if the intrinsic reward
+    // is computed here. The passes are independent and run concurrently
+    nn_job jobs[3] = {
+        {m_dqn_target, next_states_batch, q_next_target, static_cast<uint32_t>(batch_size)},
+        {m_dqn_online, states_batch, target_values, static_cast<uint32_t>(batch_size)},
+    };
+    uint32_t num_jobs = 2;
+    if (deferred_rnd) {
+        // The RND buffer is pushed in lockstep with the DQN one (same capacity), so a DQN slot
+        // holds the RND features of the same transition: the state it led to, as in the RND paper
+        embedRNDTargets(true);
+        m_rnd_replay_buffer.gatherStates(m_batch_slots, m_batch_rnd_inputs.data());
+        m_rnd_replay_buffer.gatherEmbeddings(m_batch_slots, m_batch_rnd_target.data());
+        jobs[num_jobs++] = {m_rnd_predictor, m_batch_rnd_inputs.data(), m_batch_rnd_pred.data(), static_cast<uint32_t>(batch_size)};
+    }
+    nn_predict_many(jobs, num_jobs);
 
-    double* rewards_batch = new double[batch_size];
-    double* dones_batch = new double[batch_size];
-    double* actions_batch = new double[batch_size];
-    
-    std::uniform_int_distribution<> distrib(0, replay_buffer.size() - 1);
+    // 3. Intrinsic reward terms from the predictor outputs
+    if (deferred_rnd) {
+        computeBatchIntrinsicRewards();
+    }
 
-    // 2. Sample from the replay buffer and populate the batches
+    // 4. Perform the Bellman update on the target values
     for (int i = 0; i < batch_size; ++i) {
-        int random_index = distrib(m_gen); // Use your member generator
-        const Transition& transition = replay_buffer[random_index];
+        size_t slot = m_batch_slots[i];
+        double max_next_q = *std::max_element(q_next_target + i * out_dim, q_next_target + (i + 1) * out_dim);
 
-        double* input_data = prepareInputData(transition.state, false, {}, 0);
-        double* next_input_data = prepareInputData(transition.next_state, false, {}, 0);
+        // This is the new target value for the action that was taken
+        double reward = m_replay_buffer.reward(slot) + (deferred_rnd ? m_batch_intrinsic[i] : 0.0);
+        double target_q = reward + (1.0 - m_replay_buffer.done(slot)) * m_discount_factor * max_next_q;
 
-        std::copy(input_data, input_data + dqn_parameters.DQN_INPUT_DIM, states_batch + i * dqn_parameters.DQN_INPUT_DIM);
-        std::copy(next_input_data, next_input_data + dqn_parameters.DQN_INPUT_DIM, next_states_batch + i * dqn_parameters.DQN_INPUT_DIM);
+        // Update ONLY the element for the action that was taken
+        int action_taken = m_replay_buffer.action(slot);
+        m_td_errors[i] = target_q - target_values[i * out_dim + action_taken];
+        target_values[i * out_dim + action_taken] = target_q;
+    }
+
+    // 5. Train the online network
+    if (prioritized) {
+        nn_train_weighted(m_dqn_online, states_batch, target_values, m_batch_weights.data(), batch_size);
 
-        delete[] input_data;
-        delete[] next_input_data;
-        
-        rewards_batch[i] = transition.reward;
-        dones_batch[i] = transition.done ? 1.0 : 0.0;
-        actions_batch[i] = static_cast<int>(transition.action.direction);
+        // TD errors become the new priorities of the replayed transitions
+        m_replay_buffer.updatePriorities(m_batch_slots, m_td_errors);
+    } else {
+        nn_train(m_dqn_online, states_batch, target_values, batch_size);
     }
-    
+    m_learn_steps++;
+}
 
-    double* q_next_target = new double[batch_size * dqn_parameters.DQN_OUTPUT_DIM];
-    predict_nn(0, DQN_TARGET_ID, next_states_batch, q_next_target, batch_size);
+void Trainer::computeBatchIntrinsicRewards() {
+    const int rnd_out = rnd_parameters.RND_OUTPUT_DIM;
 
-    // --- CHANGED: get Q(s, ·) from ONLINE as the base we will edit in-place
-    double* target_values = new double[batch_size * dqn_parameters.DQN_OUTPUT_DIM];
-    predict_nn(0, DQN_ONLINE_ID, states_batch, target_values, batch_size);
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    for (int i = 0; i < batch_size; ++i) {
+        double metric = rndNoveltyMetric(m_batch_rnd_pred.data() + i * rnd_out, m_batch_rnd_target.data() + i * rnd_out, rnd_out);
+        m_batch_intrinsic[i] = metric;
+        sum += metric;
+        sum_sq += metric * metric;
+    }
 
-    // 4. Perform the Bellman update on the target values
+    double mean = sum / batch_size;
+    double var = std::max(0.0, sum_sq / batch_size - mean * mean);
+    m_novelty_stats.update_stats_batch(mean, var, m_stats_new_samples);
+    m_stats_new_samples = 0;
+
+    // normalize against the updated statistics, positive novelty only like the per-step path
+    double beta = m_novelty_stats.current_beta(0);
     for (int i = 0; i < batch_size; ++i) {
-        double max_next_q = *std::max_element(q_next_target + i * dqn_parameters.DQN_OUTPUT_DIM, q_next_target + (i + 1) * dqn_parameters.DQN_OUTPUT_DIM);
+        m_batch_intrinsic[i] = beta * std::max(0.0, m_novelty_stats.peek_z_score(m_batch_intrinsic[i]));
+    }
 
-        // This is the new target value for the action that was taken
-        double target_q = rewards_batch[i] + (1.0 - dones_batch[i]) * m_discount_factor * max_next_q;
-        
-        // Update ONLY the element for the action that was taken
-        int action_taken = static_cast<int>(actions_batch[i]);
-        target_values[i * dqn_parameters.DQN_OUTPUT_DIM + action_taken] = target_q;
-    }
-
-
-    // 4. Train the online network
-    train_nn(0, DQN_ONLINE_ID, states_batch, target_values, batch_size);
-    
-    delete[] states_batch;
-    delete[] next_states_batch;
-    delete[] rewards_batch;
-    delete[] dones_batch;
-    delete[] actions_batch;
-    //delete[] online_q_values;
-    delete[] q_next_target;
-    delete[] target_values;
+    LOG_DEBUG("Batch intrinsic novelty: mean %f var %f (beta %f)", mean, var, beta);
 }
 
 void Trainer::rnd_learn_from_batch() {
-    if (m_rnd_replay_buffer.current_size() < rnd_parameters.RND_BATCH_SIZE) {
+    if (m_rnd_replay_buffer.size() < rnd_parameters.RND_BATCH_SIZE) {
         return; // Not enough data to learn
     }
 
-    double* input_data = m_rnd_replay_buffer.get_batch(rnd_parameters.RND_BATCH_SIZE);
-    double* target_data = new double[rnd_parameters.RND_BATCH_SIZE * rnd_parameters.RND_OUTPUT_DIM];
+    double* input_data = m_rnd_input_batch.data();
+    double* target_data = m_rnd_target_batch.data();
+
+    embedRNDTargets(true);
+    m_rnd_replay_buffer.sample(rnd_parameters.RND_BATCH_SIZE, m_gen, m_batch_slots);
+    m_rnd_replay_buffer.gatherStates(m_batch_slots, input_data);
 
-    // Predict using the predictor network
-    predict_nn(0, RND_TARGET_ID, input_data, target_data, rnd_parameters.RND_BATCH_SIZE);
+    // target network outputs were cached when the inputs were stored
+    m_rnd_replay_buffer.gatherEmbeddings(m_batch_slots, target_data);
 
-    // Train the target network
-    train_nn(0, RND_PREDICTOR_ID, input_data, target_data, rnd_parameters.RND_BATCH_SIZE);
+    // Train the predictor network
+    nn_train(m_rnd_predictor, input_data, target_data, rnd_parameters.RND_BATCH_SIZE);
+}
+
+void Trainer::embedRNDTargets(bool flush) {
+    m_rnd_replay_buffer.setEmbeddingVersion(nn_version(m_rnd_target));
+
+    const size_t chunk = rnd_parameters.RND_BATCH_SIZE;
+    if (!flush && (!m_rndEnabled || m_rnd_replay_buffer.pendingEmbeddings() < chunk)) {
+        return;
+    }
 
-    delete[] input_data;
-    delete[] target_data;
+    // pending slots are contiguous up to the end of the ring, so the target reads the stored
+    // rows and writes the cache rows in place
+    while (m_rnd_replay_buffer.pendingEmbeddings() > 0) {
+        size_t start = m_rnd_replay_buffer.pendingStart();
+        size_t count = std::min({m_rnd_replay_buffer.pendingEmbeddings(), chunk, m_rnd_replay_buffer.capacity() - start});
+        nn_predict(m_rnd_target, m_rnd_replay_buffer.state(start), m_rnd_replay_buffer.embedding(start), static_cast<uint32_t>(count));
+        m_rnd_replay_buffer.markEmbedded(count);
+    }
 }
 
 void Trainer::learn(State state, State prevState, Action action, double reward, bool isDone,
                     std::vector<double> food_rates, uint32_t organism_sector) {
+    if (m_queue) {
+        adoptPublishedWeights();
+
+        // encode straight into the queue, the learner stores and trains on it. If it has
+        // fallen a whole queue behind, wait for it rather than dropping transitions
+        size_t slot;
+        while (!m_queue->claim(slot)) {
+            std::this_thread::yield();
+        }
+        prepareInputData(prevState, m_queue->state(slot));
+        prepareInputData(state, m_queue->nextState(slot));
+        prepareRNDInputData(state, food_rates, organism_sector, m_queue->rndInput(slot));
+        m_queue->setTransition(slot, static_cast<int>(action.direction), reward, isDone);
+        m_queue->publish();
+        return;
+    }
+
     // Create the full transition tuple
     Transition transition;
     transition.state = prevState;
@@ -283,26 +386,42 @@ void Trainer::learn(State state, State prevState, Action action, double reward,
     // Add the transition to the replay buffer
     updateReplayBuffer(transition);
 
-    m_rnd_replay_buffer.add(prepareInputData(state, true, food_rates, organism_sector));
+    size_t rnd_slot = m_rnd_replay_buffer.push();
+    prepareRNDInputData(state, food_rates, organism_sector, m_rnd_replay_buffer.state(rnd_slot));
+    embedRNDTargets(false);
+
+    trainOnSchedule();
+}
+
+void Trainer::trainOnSchedule() {
+    if (m_rndEnabled && rnd_parameters.RND_DEFERRED) {
+        m_stats_new_samples++;
+    }
 
-    // Update target network periodically
+    // Update target network periodically, unless it tracks the online one by soft updates
     target_nn_update_counter++;
-    if (target_nn_update_counter % 2000 == 0) {
-        update_target_nn(0, 0);
+    if (dqn_parameters.TARGET_TAU <= 0.0 && target_nn_update_counter % 2000 == 0) {
+        nn_sync(m_dqn_online, m_dqn_target, 1.0);
     }
 
     // Periodically learn from a batch
     if (learning_counter == 4) {
-        if (replay_buffer.size() > dqn_parameters.DQN_BATCH_SIZE) {
+        if (m_replay_buffer.size() > dqn_parameters.DQN_BATCH_SIZE) {
             learn_from_batch();
             learning_counter = 0;
+            if (dqn_parameters.TARGET_TAU > 0.0) {
+                nn_sync(m_dqn_online, m_dqn_target, std::min(dqn_parameters.TARGET_TAU, 1.0));
+            }
+            if (m_queue && ++m_steps_since_publish >= learner_parameters.PUBLISH_INTERVAL) {
+                publishWeights();
+            }
         }
     } else {
         learning_counter++;
     }
 
     if (m_rnd_counter == 100 && m_rndEnabled) {
-        if (m_rnd_replay_buffer.current_size() > rnd_parameters.RND_BATCH_SIZE) {
+        if (m_rnd_replay_buffer.size() > rnd_parameters.RND_BATCH_SIZE) {
             rnd_learn_from_batch();
         }
         m_rnd_counter = 0;
@@ -311,14 +430,310 @@ void Trainer::learn(State state, State prevState, Action action, double reward,
     }
 }
 
-void Trainer::updateReplayBuffer(Transition transition) {
-    if (replay_buffer.size() < replay_buffer_size) {
-        replay_buffer.push_back(transition);
-    } else {
-        // delete the oldest state and add the new one
-        replay_buffer.erase(replay_buffer.begin());
-        replay_buffer.push_back(transition);
+void Trainer::startLearner() {
+    // Actor copies, plus staging copies the learner publishes into
+    m_actor.dqn_online = nn_clone(m_dqn_online);
+    m_actor.rnd_predictor = nn_clone(m_rnd_predictor);
+    m_actor.rnd_target = nn_clone(m_rnd_target); // never trained, only needs its own buffers
+    m_staging_dqn = nn_clone(m_dqn_online);
+    m_staging_rnd = nn_clone(m_rnd_predictor);
+
+    m_queue = std::make_unique<TransitionQueue>(learner_parameters.TRANSITION_QUEUE_CAPACITY,
+                                                dqn_parameters.DQN_INPUT_DIM, rnd_parameters.RND_INPUT_DIM);
+    m_learner = std::thread(&Trainer::learnerLoop, this);
+    std::cout << "Async learner started (publishing every " << learner_parameters.PUBLISH_INTERVAL << " steps)" << std::endl;
+}
+
+void Trainer::stopLearner() {
+    if (!m_learner.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_learner_mutex);
+        m_learner_stop = true;
     }
+    m_learner_cv.notify_all();
+    m_learner.join();
 }
 
+void Trainer::learnerLoop() {
+    while (true) {
+        size_t stored = drainQueue();
+
+        if (m_learner_stop.load(std::memory_order_acquire)) {
+            drainQueue();
+            return;
+        }
+
+        if (m_pause_requested.load(std::memory_order_acquire)) {
+            drainQueue(); // everything the actor pushed before pausing is in the buffers
+            std::unique_lock<std::mutex> lock(m_learner_mutex);
+            m_learner_paused = true;
+            m_learner_cv.notify_all();
+            m_learner_cv.wait(lock, [this] { return !m_pause_requested.load() || m_learner_stop.load(); });
+            m_learner_paused = false;
+            continue;
+        }
 
+        if (stored == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+size_t Trainer::drainQueue() {
+    const size_t in_dim = dqn_parameters.DQN_INPUT_DIM;
+    const size_t rnd_dim = rnd_parameters.RND_INPUT_DIM;
+
+    size_t stored = 0;
+    size_t slot;
+    while (m_queue->front(slot)) {
+        size_t dqn_slot = m_replay_buffer.push();
+        std::copy(m_queue->state(slot), m_queue->state(slot) + in_dim, m_replay_buffer.state(dqn_slot));
+        std::copy(m_queue->nextState(slot), m_queue->nextState(slot) + in_dim, m_replay_buffer.nextState(dqn_slot));
+        m_replay_buffer.setTransition(dqn_slot, m_queue->action(slot), m_queue->reward(slot), m_queue->done(slot));
+
+        size_t rnd_slot = m_rnd_replay_buffer.push();
+        std::copy(m_queue->rndInput(slot), m_queue->rndInput(slot) + rnd_dim, m_rnd_replay_buffer.state(rnd_slot));
+        embedRNDTargets(false);
+
+        m_queue->pop(); // free the slot before training so the actor can go on
+        stored++;
+
+        trainOnSchedule();
+    }
+    return stored;
+}
+
+void Trainer::publishWeights() {
+    std::lock_guard<std::mutex> lock(m_publish_mutex);
+    nn_sync(m_dqn_online, m_staging_dqn, 1.0);
+    nn_sync(m_rnd_predictor, m_staging_rnd, 1.0);
+    m_published_version.fetch_add(1, std::memory_order_release);
+    m_steps_since_publish = 0;
+}
+
+void Trainer::adoptPublishedWeights() {
+    if (m_published_version.load(std::memory_order_acquire) == m_adopted_version) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_publish_mutex);
+    nn_sync(m_staging_dqn, m_actor.dqn_online, 1.0);
+    nn_sync(m_staging_rnd, m_actor.rnd_predictor, 1.0);
+    m_adopted_version = m_published_version.load(std::memory_order_relaxed);
+}
+
+void Trainer::pauseLearner() {
+    if (!m_learner.joinable()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_learner_mutex);
+    if (m_pause_depth++ == 0) {
+        m_pause_requested = true;
+    }
+    m_learner_cv.wait(lock, [this] { return m_learner_paused; });
+}
+
+void Trainer::resumeLearner() {
+    if (!m_learner.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_learner_mutex);
+        if (--m_pause_depth > 0) {
+            return;
+        }
+        m_pause_requested = false;
+    }
+    m_learner_cv.notify_all();
+}
+
+void Trainer::setRNDEnabled(bool enabled) {
+    pauseLearner();
+    m_rndEnabled = enabled;
+    resumeLearner();
+}
+
+void Trainer::updateReplayBuffer(const Transition& transition) {
+    // O(1): encode into the next ring slot, overwriting the oldest transition once full
+    size_t slot = m_replay_buffer.push();
+    prepareInputData(transition.state, m_replay_buffer.state(slot));
+    prepareInputData(transition.next_state, m_replay_buffer.nextState(slot));
+    m_replay_buffer.setTransition(slot, static_cast<int>(transition.action.direction), transition.reward, transition.done);
+}
+
+void Trainer::saveModels() {
+    pauseLearner(); // the weights are copied out, the writes happen in the background
+    // collect the saves queued last time, still pending ones are kept
+    size_t kept = 0;
+    for (uint64_t ticket : m_checkpoint_tickets) {
+        int32_t status = checkpoint_status(ticket);
+        if (status == 0) {
+            m_checkpoint_tickets[kept++] = ticket;
+        } else if (status < 0) {
+            LOG_WARNING("Checkpoint %llu failed to write", static_cast<unsigned long long>(ticket));
+        }
+    }
+    m_checkpoint_tickets.resize(kept);
+
+    const std::pair<nn_network*, const char*> models[] = {
+        {m_dqn_online, m_model_path.c_str()},
+        {m_rnd_predictor, RND_PREDICTOR_PATH},
+        {m_rnd_target, RND_TARGET_PATH},
+    };
+    for (const auto& [network, dirname] : models) {
+        uint64_t ticket = nn_save_async(network, dirname);
+        if (ticket == 0) {
+            LOG_WARNING("Could not queue checkpoint for %s", dirname);
+            continue;
+        }
+        m_checkpoint_tickets.push_back(ticket);
+    }
+    resumeLearner();
+}
+
+bool Trainer::waitForCheckpoints() {
+    uint32_t failures = wait_checkpoints();
+    m_checkpoint_tickets.clear();
+    if (failures > 0) {
+        std::cerr << failures << " checkpoint(s) failed to write" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+namespace {
+    struct TrainingStateHeader {
+        char magic[8];          // "RLSTATE"
+        uint32_t version;
+        uint32_t has_policy;
+        int64_t learning_counter;
+        int64_t target_nn_update_counter;
+        int64_t rnd_counter;
+        int64_t learn_steps;
+        double temperature;
+        int64_t decay_counter;
+        uint64_t stats_n;
+        double stats_mu;
+        double stats_m2;
+        double rnd_target_fingerprint;
+    };
+}
+
+double Trainer::rndTargetFingerprint() {
+    const int in_dim = rnd_parameters.RND_INPUT_DIM;
+    const int out_dim = rnd_parameters.RND_OUTPUT_DIM;
+    std::vector<double> probe(in_dim);
+    std::vector<double> out(out_dim);
+    for (int i = 0; i < in_dim; ++i) {
+        probe[i] = static_cast<double>(i + 1) / in_dim;
+    }
+    nn_predict(m_rnd_target, probe.data(), out.data(), 1);
+
+    double fingerprint = 0.0;
+    for (int k = 0; k < out_dim; ++k) {
+        fingerprint += (k + 1) * out[k];
+    }
+    return fingerprint;
+}
+
+bool Trainer::saveTrainingState(const std::string& path, const BoltzmannPolicy* policy) {
+    pauseLearner(); // buffers and counters belong to the learner
+    TrainingStateHeader header = {};
+    std::memcpy(header.magic, "RLSTATE", 7);
+    header.version = TRAINING_STATE_VERSION;
+    header.has_policy = policy ? 1 : 0;
+    header.learning_counter = learning_counter;
+    header.target_nn_update_counter = target_nn_update_counter;
+    header.rnd_counter = m_rnd_counter;
+    header.learn_steps = m_learn_steps;
+    if (policy) {
+        header.temperature = policy->getTemperature();
+        header.decay_counter = policy->getDecayCounter();
+    }
+    header.stats_n = m_novelty_stats.n;
+    header.stats_mu = m_novelty_stats.mu;
+    header.stats_m2 = m_novelty_stats.m2;
+    header.rnd_target_fingerprint = rndTargetFingerprint();
+
+    // written next to the old state and renamed over it, a crash mid-save keeps the old one
+    const std::string tmp_path = path + ".tmp";
+    try {
+        std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open " + tmp_path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        m_replay_buffer.write(out);
+        m_rnd_replay_buffer.write(out);
+        out.close();
+        if (!out) {
+            throw std::runtime_error("Cannot write " + tmp_path);
+        }
+        std::filesystem::rename(tmp_path, path);
+    } catch (const std::exception& e) {
+        std::cerr << "Error saving training state: " << e.what() << std::endl;
+        std::error_code ignored;
+        std::filesystem::remove(tmp_path, ignored);
+        resumeLearner();
+        return false;
+    }
+
+    LOG_INFO("Saved training state to %s (%zu transitions)", path.c_str(), m_replay_buffer.size());
+    resumeLearner();
+    return true;
+}
+
+bool Trainer::loadTrainingState(const std::string& path, BoltzmannPolicy* policy) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    pauseLearner();
+    try {
+        TrainingStateHeader header;
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, "RLSTATE", 7) != 0) {
+            throw std::runtime_error("not a training state file");
+        }
+        if (header.version != TRAINING_STATE_VERSION) {
+            throw std::runtime_error("unsupported version " + std::to_string(header.version));
+        }
+        // checkpoints store the weights exactly, the same target gives the same outputs
+        if (header.rnd_target_fingerprint != rndTargetFingerprint()) {
+            throw std::runtime_error("RND target network differs from the one the state was saved with (missing " RND_TARGET_PATH "?)");
+        }
+
+        // Deferred RND reads DQN slot i and RND slot i as one transition, so the buffers are
+        // parsed into copies and only swapped in once both (and the header) are complete: a
+        // truncated file leaves the trainer exactly as it was
+        ReplayBuffer replay_buffer = m_replay_buffer;
+        ReplayBuffer rnd_replay_buffer = m_rnd_replay_buffer;
+        replay_buffer.read(in);
+        rnd_replay_buffer.read(in);
+        if (replay_buffer.size() != rnd_replay_buffer.size()) {
+            throw std::runtime_error("DQN and RND replay buffers hold different numbers of transitions");
+        }
+
+        m_replay_buffer = std::move(replay_buffer);
+        m_rnd_replay_buffer = std::move(rnd_replay_buffer);
+        learning_counter = static_cast<int>(header.learning_counter);
+        target_nn_update_counter = static_cast<int>(header.target_nn_update_counter);
+        m_rnd_counter = static_cast<int>(header.rnd_counter);
+        m_learn_steps = static_cast<long>(header.learn_steps);
+        if (policy && header.has_policy) {
+            policy->restoreState(header.temperature, static_cast<int>(header.decay_counter));
+        }
+        m_novelty_stats.n = header.stats_n;
+        m_novelty_stats.mu = header.stats_mu;
+        m_novelty_stats.m2 = header.stats_m2;
+    } catch (const std::exception& e) {
+        std::cerr << "Error loading training state " << path << ": " << e.what() << std::endl;
+        resumeLearner();
+        return false;
+    }
+
+    std::cout << "Resumed training state from " << path << " (" << m_replay_buffer.size() << " transitions)" << std::endl;
+    resumeLearner();
+    return true;
+}
@@ -0,0 +1,125 @@
+#include <config.h>
+#include <nn_api.h>
+#include <filesystem>
+#include <iostream>
+
+IO_FRONTEND::RND_Params rnd_parameters;
+IO_FRONTEND::DQN_Params dqn_parameters;
+IO_FRONTEND::BoltzmannPolicy_Params boltzmann_parameters;
+IO_FRONTEND::PER_Params per_parameters;
+IO_FRONTEND::Learner_Params learner_parameters;
+int replay_buffer_capacity = 0;
+
+namespace {
+    bool s_loaded = false;
+    uint32_t s_generation = 0;
+    std::string s_rl_params_path;
+    std::filesystem::file_time_type s_rl_params_mtime;
+
+    struct RLParams {
+        IO_FRONTEND::RND_Params rnd;
+        IO_FRONTEND::DQN_Params dqn;
+        IO_FRONTEND::BoltzmannPolicy_Params boltzmann;
+        IO_FRONTEND::PER_Params per;
+        IO_FRONTEND::Learner_Params learner;
+        int capacity = 0;
+    };
+
+    bool parse_rl_params(const std::string& path, RLParams& params) {
+        return IO_FRONTEND::parse_rnd_params(path, params.rnd) &&
+               IO_FRONTEND::parse_dqn_params(path, params.dqn) &&
+               IO_FRONTEND::parse_boltzmann_params(path, params.boltzmann) &&
+               IO_FRONTEND::parse_per_params(path, params.per) &&
+               IO_FRONTEND::parse_learner_params(path, params.learner) &&
+               IO_FRONTEND::parse_buffer_capacity(path, params.capacity);
+    }
+
+    void apply(const RLParams& params) {
+        rnd_parameters = params.rnd;
+        dqn_parameters = params.dqn;
+        boltzmann_parameters = params.boltzmann;
+        per_parameters = params.per;
+        learner_parameters = params.learner;
+        replay_buffer_capacity = params.capacity;
+        s_generation++;
+    }
+
+    // Values baked into allocated networks and buffers
+    bool same_shapes(const RLParams& params) {
+        const auto& r = params.rnd;
+        const auto& d = params.dqn;
+        return r.RND_INPUT_DIM == rnd_parameters.RND_INPUT_DIM && r.RND_OUTPUT_DIM == rnd_parameters.RND_OUTPUT_DIM &&
+               r.RND_HIDDEN_DIM == rnd_parameters.RND_HIDDEN_DIM && r.RND_NUM_LAYERS == rnd_parameters.RND_NUM_LAYERS &&
+               r.RND_BATCH_SIZE == rnd_parameters.RND_BATCH_SIZE &&
+               d.DQN_INPUT_DIM == dqn_parameters.DQN_INPUT_DIM && d.DQN_OUTPUT_DIM == dqn_parameters.DQN_OUTPUT_DIM &&
+               d.DQN_HIDDEN_DIM == dqn_parameters.DQN_HIDDEN_DIM && d.DQN_NUM_LAYERS == dqn_parameters.DQN_NUM_LAYERS &&
+               d.DQN_BATCH_SIZE == dqn_parameters.DQN_BATCH_SIZE &&
+               params.capacity == replay_buffer_capacity &&
+               params.per.PRIORITIZED_REPLAY == per_parameters.PRIORITIZED_REPLAY &&
+               params.learner.ASYNC_LEARNER == learner_parameters.ASYNC_LEARNER &&
+               params.learner.TRANSITION_QUEUE_CAPACITY == learner_parameters.TRANSITION_QUEUE_CAPACITY;
+    }
+}
+
+namespace config {
+
+    bool load(const std::string& rl_params_path) {
+        if (s_loaded) {
+            return true;
+        }
+
+        if (parse_nn_params() != 0) { // parse the hyperparams used in the nn backend
+            std::cerr << "Error parsing NN parameters" << std::endl;
+            return false;
+        }
+
+        RLParams params;
+        if (!parse_rl_params(rl_params_path, params)) {
+            std::cerr << "Error parsing parameters for frontend: " << rl_params_path << std::endl;
+            return false;
+        }
+
+        std::error_code ec;
+        s_rl_params_mtime = std::filesystem::last_write_time(rl_params_path, ec);
+        s_rl_params_path = rl_params_path;
+
+        apply(params);
+        s_loaded = true;
+        return true;
+    }
+
+    bool reload() {
+        if (!s_loaded) {
+            return load();
+        }
+
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(s_rl_params_path, ec);
+        if (ec || mtime == s_rl_params_mtime) {
+            return false;
+        }
+        s_rl_params_mtime = mtime;
+
+        RLParams params;
+        if (!parse_rl_params(s_rl_params_path, params)) {
+            std::cerr << "Config reload failed, keeping the current parameters" << std::endl;
+            return false;
+        }
+        if (!same_shapes(params)) {
+            std::cerr << "Config reload rejected: network, buffer, replay or learner mode changed, restart to apply" << std::endl;
+            return false;
+        }
+
+        apply(params);
+        std::cout << "Reloaded " << s_rl_params_path << std::endl;
+        return true;
+    }
+
+    bool loaded() {
+        return s_loaded;
+    }
+
+    uint32_t generation() {
+        return s_generation;
+    }
+}
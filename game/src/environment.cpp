@@ -0,0 +1,84 @@
+#include <environment.h>
+#include <metrics.h>
+#include <algorithm>
+#include <cmath>
+
+Environment::Environment(Map* map, Organism* organism, Agent* agent, Trainer* trainer) :
+    m_map(map),
+    m_organism(organism),
+    m_agent(agent),
+    m_trainer(trainer) {
+
+    std::random_device rd;
+    m_gen = std::mt19937(rd());
+}
+
+void Environment::reset() {
+    m_map->reset();
+
+    // Center at 400px, stddev ≈ 800/6 ≈ 133px covers ±2σ ≈ 66%
+    // Use smaller σ (≈800/9≈89px) to tighten to ≈90% within ±3σ (~±267px)
+    std::normal_distribution<> distX(400.0, 89.0);
+    std::normal_distribution<> distY(300.0, 67.0);  // for 600 height
+
+    int x = std::clamp<int>(std::round(distX(m_gen)), 10, 790);
+    int y = std::clamp<int>(std::round(distY(m_gen)), 10, 590);
+
+    m_organism->reset(x, y);
+    m_timestep = 0;
+}
+
+bool Environment::step(Action action) {
+    bool running = true;
+
+    int x, y;
+    m_organism->getPosition(x, y);
+
+    int dx = 0, dy = 0;
+    switch (action.direction) {
+        case UP:    dy = -1; break;
+        case DOWN:  dy = +1; break;
+        case LEFT:  dx = -1; break;
+        case RIGHT: dx = +1; break;
+    }
+
+    if (dx != 0 || dy != 0) {
+        // proposed new position
+        int speed = m_organism->getGenome().speed;
+        int newX = x + dx * speed;
+        int newY = y + dy * speed;
+
+        m_timestep++;
+
+        std::vector<double> food_rates = m_map->getFoodCounts();
+
+        // compute rates food_counts/timestep
+        for (int i = 0; i < food_rates.size(); ++i) {
+            food_rates[i] = static_cast<double>(food_rates[i] / (m_timestep + 1));
+        }
+
+        uint32_t sector = m_map->getSector(x, y);
+
+        // only move if there is no wall at the target
+        bool hit_wall = m_map->isWall(newX, newY);
+
+        double reward = computeReward(m_agent->getState(), action, food_rates, sector, m_rndEnabled,
+            m_trainer->intrinsicRewardContext(), hit_wall, x, y, m_organism->getDirection(), m_map->getWallPosX(newX, newY), m_map->getWallPosY(newX, newY));
+
+        State prevState = m_agent->getState();
+
+        running = hit_wall ? m_organism->move(0, 0) : m_organism->move(dx, dy);
+        bool is_eating = m_map->isEating();
+
+        m_agent->updateState(m_map, is_eating);
+        m_trainer->learn(m_agent->getState(), prevState, action, reward, running, food_rates, sector);
+
+        m_map->resetEating(); // Reset eating flag after the transition is stored
+
+        Metrics::getInstance().commitStep(m_episode, m_timestep, m_id, prevState.energy_lvl);
+    }
+
+    m_map->organismCollisionFood(m_organism);
+
+    return running;
+}
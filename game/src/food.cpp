@@ -8,9 +8,11 @@ bool Food::move(int dx, int dy) {
     // Food does not move
 }
 
+#ifndef HEADLESS
 void Food::draw(SDL_Renderer* renderer) {
 
     // Draw food as a filled circle
     SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); // Red color
     drawCircle(renderer, x, y, FOOD_SIZE, true);
-}
\ No newline at end of file
+}
+#endif
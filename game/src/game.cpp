@@ -1,13 +1,9 @@
 #include <game.h>
 #include <rl_utils.h>
 #include <logger.h>
+#include <metrics.h>
 #include <io_frontend.h>
 
-#define MAP_WIDTH 900
-#define MAP_HEIGHT 900
-
-
-
 Game::Game() : m_currentState(GameState::MENU), m_totalEpisodes(0), m_currentEpisode(0) {
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         std::cerr << "SDL init failed: " << SDL_GetError() << std::endl;
@@ -42,12 +38,15 @@ Game::Game() : m_currentState(GameState::MENU), m_totalEpisodes(0), m_currentEpi
     //m_map->addOrganism(x, y, {1, MAX_ORGANISM_VISION_DEPTH, MAX_ORGANISM_SPEED, MIN_ORGANISM_SIZE});
 
     m_agent = new Agent(m_organism);
-    int buf_size;
-    IO_FRONTEND::parse_buffer_capacity("../game/rl_system.params", buf_size);
-    m_trainer = new Trainer(m_agent, m_map, 0.9, 0.001, "models/dqn_model", buf_size, false);
+    if (!config::load()) {
+        exit(1);
+    }
+    m_trainer = new Trainer(m_agent, m_map, 0.9, 0.001, DQN_MODEL_PATH, replay_buffer_capacity, false);
+    m_env = new Environment(m_map, m_organism, m_agent, m_trainer);
 }
 
 Game::~Game() {
+    delete m_env;
     delete m_map;
     delete m_organism;
     delete m_agent;
@@ -146,20 +145,10 @@ void Game::runEpisodes(int episodes) {
     
     for (int i = 0; i < episodes; ++i) {
 
-        Logger::getInstance().log(LogType::INFO, "---------- Episode " + std::to_string(i + 1) + " of " + std::to_string(episodes) + " ----------");
-        m_map->reset();
-        std::random_device rd;
-        std::mt19937 gen(rd());
-    
-        // Center at 400px, stddev ≈ 800/6 ≈ 133px covers ±2σ ≈ 66%
-        // Use smaller σ (≈800/9≈89px) to tighten to ≈90% within ±3σ (~±267px)
-        std::normal_distribution<> distX(400.0, 89.0);
-        std::normal_distribution<> distY(300.0, 67.0);  // for 600 height
-    
-        int x = std::clamp<int>(std::round(distX(gen)), 10, 790);
-        int y = std::clamp<int>(std::round(distY(gen)), 10, 590);
-        
-        m_organism->reset(x, y);
+        LOG_INFO("---------- Episode %d of %d ----------", i + 1, episodes);
+        m_env->reset();
+        m_env->setEpisode(i + 1);
+        Metrics::getInstance().beginEpisode(i + 1);
 
         bool running = true;
         SDL_Event event;
@@ -183,77 +172,8 @@ void Game::runEpisodes(int episodes) {
             SDL_SetRenderDrawColor(m_renderer, 255, 255, 255, 255);
             SDL_RenderClear(m_renderer);
 
-            int x, y;
-            m_organism->getPosition(x, y);
-
-            int dx = 0, dy = 0;
-
-            Action action = m_agent->chooseAction();
-
-            
-            switch (action.direction) {
-                case UP:    dy = -1; break;
-                case DOWN:  dy = +1; break;
-                case LEFT:  dx = -1; break;
-                case RIGHT: dx = +1; break;
-            }
-
-            if (dx != 0 || dy != 0) {
-                // proposed new position
-                int speed = m_organism->getGenome().speed;
-                int newX = x + dx * speed;
-                int newY = y + dy * speed;
-
-                timestep++;
-                
-                std::vector<double> food_rates = m_map->getFoodCounts();
-
-                // compute rates food_counts/timestep
-                for (int i = 0; i < food_rates.size(); ++i) {
-                    food_rates[i] = static_cast<double>(food_rates[i] / (timestep + 1));
-                }
-
-                uint32_t sector = m_organism->getSector(m_map->getWidth(), m_map->getHeight());
-                
-            
-                // only move if there is no wall at the target
-                if (!m_map->isWall(newX, newY)) {
-                    // print check
-                    double reward = computeReward(m_agent->getState(), action, food_rates, sector, m_rndEnabled, 
-                        false, x, y, m_organism->getDirection(), m_map->getWallPosX(newX, newY), m_map->getWallPosY(newX, newY));
-                    // passed reward print check
-
-                    State prevState = m_agent->getState();
-
-                    running = m_organism->move(dx, dy);
-                    bool is_eating = m_map->isEating();
-
-                    // print check is_eating
-                    m_agent->updateState(m_map, is_eating);
-                    //m_trainer->updateReplayBuffer(m_agent->getState());
-                    m_trainer->learn(m_agent->getState(), prevState, action, reward, running, food_rates, sector); // reward is 0 for now
-                }
-                else {
-                    // print check
-                    double reward = computeReward(m_agent->getState(), action, food_rates, sector, m_rndEnabled, 
-                        true, x, y, m_organism->getDirection(), m_map->getWallPosX(newX, newY), m_map->getWallPosX(newX, newY));
-                    // passed reward print check
-
-                    State prevState = m_agent->getState();
-
-                    running = m_organism->move(0, 0);
-                    bool is_eating = m_map->isEating();
-                    m_agent->updateState(m_map, is_eating);
-                    //m_trainer->updateReplayBuffer(m_agent->getState());
-                    m_trainer->learn(m_agent->getState(), prevState, action, reward, running, food_rates, sector); // reward is 0 for now
-                }
-                m_map->resetEating(); // Reset eating flag after drawing
-            }
-
-            int org_x, org_y;
-            m_organism->getPosition(org_x, org_y);
-
-            m_map->organismCollisionFood((Organism*) m_organism);
+            Action action = m_agent->chooseAction(m_trainer->actorNetworks().dqn_online);
+            running = m_env->step(action);
 
             m_map->draw_map(m_renderer);
             m_organism->draw(m_renderer);
@@ -264,11 +184,11 @@ void Game::runEpisodes(int episodes) {
 
         }
 
-        save_nn_model(0, 0, "models/dqn_model");
-        // save rnd predictor model
-        save_nn_model(0, 2, "models/rnd_model/test_model/predictor");
-        // save rnd target model
-        save_nn_model(0, 3, "models/rnd_model/test_model/target");
+        m_trainer->saveModels();
+        Metrics::getInstance().endEpisode(i + 1, m_env->getTimestep());
+        m_trainer->pauseLearner(); // the learner reads the params
+        config::reload(); // pick up edited params between episodes
+        m_trainer->resumeLearner();
 
         SDL_SetRenderDrawColor(m_renderer, 255, 255, 255, 255);
         SDL_RenderClear(m_renderer);
@@ -276,12 +196,12 @@ void Game::runEpisodes(int episodes) {
 
         SDL_Delay(500);
 
-        Logger::getInstance().log(LogType::DEBUG, "Final Timestep: " + std::to_string(timestep));
+        LOG_DEBUG("Final Timestep: %d", m_env->getTimestep());
 
-        timestep = 0;
-        Logger::getInstance().log(LogType::DEBUG, "-------- End of Episode " + std::to_string(i + 1) + " --------\n\n");
+        LOG_DEBUG("-------- End of Episode %d --------\n\n", i + 1);
     }
 
+    m_trainer->waitForCheckpoints();
     m_currentState = GameState::MENU;
 }
 
@@ -427,4 +347,5 @@ void Game::showMenu() {
     m_rndEnabled = rndEnabled;
 
     m_trainer->setRNDEnabled(m_rndEnabled);
+    m_env->setRNDEnabled(m_rndEnabled);
 }
@@ -0,0 +1,181 @@
+#include <iostream>
+#include <string>
+#include <cstring>
+#include <csignal>
+
+#include <map.h>
+#include <organism.h>
+#include <agent.h>
+#include <vec_env.h>
+#include <logger.h>
+#include <metrics.h>
+#include <io_frontend.h>
+
+// Headless trainer: runs the same Map/Organism/Agent/Trainer loop as the SDL game,
+// without a window, menu or frame delay. With --envs N, N maps are stepped in lockstep
+// and share one batched forward pass per step.
+
+static void printUsage(const char* prog) {
+    std::cout << "Usage: " << prog << " [--policy boltzmann] [--rnd] [--envs N] [--resume] [--state-every N] --episodes N" << std::endl;
+}
+
+// Set by SIGINT/SIGTERM (e.g. a preempted job), the loop stops and saves the training state
+static volatile std::sig_atomic_t g_stop_requested = 0;
+
+static void requestStop(int) {
+    g_stop_requested = 1;
+}
+
+int main(int argc, char* argv[]) {
+    PolicyType policy = PolicyType::BOLTZMANN;
+    bool rndEnabled = false;
+    int episodes = 0;
+    int num_envs = 1;
+    bool resume = false;
+    int state_every = 0; // episodes between training state saves, 0 = only when the run stops
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--policy" && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "boltzmann") {
+                policy = PolicyType::BOLTZMANN;
+            } else if (name == "epsilon-greedy") {
+                // Agent/VecEnv only implement Boltzmann exploration
+                std::cerr << "The epsilon-greedy policy is not supported, use --policy boltzmann" << std::endl;
+                return 1;
+            } else {
+                std::cerr << "Unknown policy: " << name << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--rnd") {
+            rndEnabled = true;
+        } else if (arg == "--episodes" && i + 1 < argc) {
+            try {
+                episodes = std::stoi(argv[++i]);
+            } catch (...) {
+                episodes = 0;
+            }
+        } else if (arg == "--envs" && i + 1 < argc) {
+            try {
+                num_envs = std::stoi(argv[++i]);
+            } catch (...) {
+                num_envs = 0;
+            }
+        } else if (arg == "--resume") {
+            resume = true;
+        } else if (arg == "--state-every" && i + 1 < argc) {
+            try {
+                state_every = std::stoi(argv[++i]);
+            } catch (...) {
+                state_every = -1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (episodes <= 0) {
+        std::cerr << "Number of episodes must be positive" << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (num_envs <= 0) {
+        std::cerr << "Number of envs must be positive" << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (state_every < 0) {
+        std::cerr << "--state-every must not be negative" << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Logger::getInstance().init("system.log");
+    Metrics::getInstance().init("metrics.bin");
+
+    VecEnv envs(num_envs, {1, MAX_ORGANISM_VISION_DEPTH, MAX_ORGANISM_SPEED, 15});
+
+    if (!config::load()) {
+        return 1;
+    }
+    Trainer trainer(envs.getAgent(0), envs.getMap(0), 0.9, 0.001, DQN_MODEL_PATH, replay_buffer_capacity, rndEnabled);
+
+    envs.setTrainer(&trainer);
+    envs.setPolicy(policy);
+    envs.setRNDEnabled(rndEnabled);
+
+    // the networks (with their optimizer state) are picked up from models/ by the Trainer,
+    // this restores the rest
+    if (resume && !trainer.loadTrainingState(TRAINING_STATE_PATH, envs.getPolicy())) {
+        std::cout << "No usable training state in " << TRAINING_STATE_PATH << ", starting with empty replay buffers" << std::endl;
+    }
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    std::cout << "Running " << episodes << " headless episodes on " << num_envs << " env(s) (RND: " << (rndEnabled ? "ON" : "OFF") << ")" << std::endl;
+
+    // episode number currently running in each env
+    std::vector<int> env_episode(num_envs, 0);
+    int started = 0;
+    int completed = 0;
+
+    envs.reset();
+    for (int e = 0; e < num_envs && started < episodes; ++e) {
+        env_episode[e] = ++started;
+        envs.setEpisode(e, started);
+        Metrics::getInstance().beginEpisode(started);
+        LOG_INFO("---------- Episode %d of %d ----------", started, episodes);
+    }
+
+    while (completed < episodes && !g_stop_requested) {
+        for (int e : envs.step()) {
+            int episode = env_episode[e];
+            if (episode == 0) {
+                continue; // env only keeps running to fill the batch, its episode is not counted
+            }
+            completed++;
+
+            Metrics::getInstance().endEpisode(episode, envs.getEpisodeLength(e));
+
+            trainer.saveModels();
+            if (state_every > 0 && completed % state_every == 0) {
+                trainer.saveTrainingState(TRAINING_STATE_PATH, envs.getPolicy());
+            }
+            trainer.pauseLearner(); // the learner reads the params
+            config::reload(); // pick up edited params between episodes
+            trainer.resumeLearner();
+
+            LOG_DEBUG("Final Timestep: %d", envs.getEpisodeLength(e));
+            LOG_DEBUG("-------- End of Episode %d --------\n\n", episode);
+
+            std::cout << "Episode " << episode << "/" << episodes << " finished after " << envs.getEpisodeLength(e) << " steps" << std::endl;
+
+            if (completed >= episodes) {
+                break;
+            }
+            if (started < episodes) {
+                env_episode[e] = ++started;
+                envs.setEpisode(e, started);
+                Metrics::getInstance().beginEpisode(started);
+                LOG_INFO("---------- Episode %d of %d ----------", started, episodes);
+            } else {
+                env_episode[e] = 0;
+                envs.setEpisode(e, 0); // filler steps are tagged episode 0
+            }
+        }
+    }
+
+    if (g_stop_requested) {
+        std::cout << "Stopping after " << completed << " episodes, saving training state" << std::endl;
+        trainer.saveModels(); // weights matching the state, episodes may be mid-way
+    }
+    trainer.saveTrainingState(TRAINING_STATE_PATH, envs.getPolicy());
+    trainer.waitForCheckpoints(); // last saves are still in flight
+
+    return 0;
+}
@@ -85,6 +85,7 @@ void parse_rnd_params_impl(const std::string& file_path, IO_FRONTEND::RND_Params
                 else if (key == "RND_HIDDEN_DIM") params.RND_HIDDEN_DIM = std::stoi(value_str);
                 else if (key == "RND_NUM_LAYERS") params.RND_NUM_LAYERS = std::stoi(value_str);
                 else if (key == "RND_BATCH_SIZE") params.RND_BATCH_SIZE = std::stoi(value_str);
+                else if (key == "RND_DEFERRED") params.RND_DEFERRED = std::stoi(value_str);
             }
         }
     }
@@ -129,6 +130,7 @@ void parse_dqn_params_impl(const std::string& file_path, IO_FRONTEND::DQN_Params
                 else if (key == "DQN_HIDDEN_DIM") params.DQN_HIDDEN_DIM = std::stoi(value_str);
                 else if (key == "DQN_NUM_LAYERS") params.DQN_NUM_LAYERS = std::stoi(value_str);
                 else if (key == "DQN_BATCH_SIZE") params.DQN_BATCH_SIZE = std::stoi(value_str);
+                else if (key == "TARGET_TAU") params.TARGET_TAU = std::stod(value_str);
             }
         }
     }
@@ -177,6 +179,92 @@ void parse_boltzmann_params_impl(const std::string& file_path, IO_FRONTEND::Bolt
     }
 }
 
+// Function to parse parameters for PER_Params
+void parse_per_params_impl(const std::string& file_path, IO_FRONTEND::PER_Params& params) {
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + file_path);
+    }
+
+    std::string line;
+    bool in_per_spec = false;
+    while (std::getline(file, line)) {
+        line = trim(line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        if (line.find("PER_specs") != std::string::npos) {
+            in_per_spec = true;
+            continue;
+        }
+        if (in_per_spec && line.find('}') != std::string::npos) {
+            in_per_spec = false;
+            continue;
+        }
+
+        if (in_per_spec) {
+            size_t equals_pos = line.find('=');
+            if (equals_pos != std::string::npos) {
+                std::string key = trim(line.substr(0, equals_pos));
+                std::string value_str = trim(line.substr(equals_pos + 1));
+                
+                if (!value_str.empty() && value_str.back() == ';') {
+                    value_str.pop_back();
+                }
+
+                if (key == "PRIORITIZED_REPLAY") params.PRIORITIZED_REPLAY = std::stoi(value_str);
+                else if (key == "PER_ALPHA") params.PER_ALPHA = std::stod(value_str);
+                else if (key == "PER_BETA_START") params.PER_BETA_START = std::stod(value_str);
+                else if (key == "PER_BETA_STEPS") params.PER_BETA_STEPS = std::stoi(value_str);
+                else if (key == "PER_EPS") params.PER_EPS = std::stod(value_str);
+            }
+        }
+    }
+}
+
+// Function to parse parameters for Learner_Params
+void parse_learner_params_impl(const std::string& file_path, IO_FRONTEND::Learner_Params& params) {
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + file_path);
+    }
+
+    std::string line;
+    bool in_learner_spec = false;
+    while (std::getline(file, line)) {
+        line = trim(line);
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+
+        if (line.find("Learner_specs") != std::string::npos) {
+            in_learner_spec = true;
+            continue;
+        }
+        if (in_learner_spec && line.find('}') != std::string::npos) {
+            in_learner_spec = false;
+            continue;
+        }
+
+        if (in_learner_spec) {
+            size_t equals_pos = line.find('=');
+            if (equals_pos != std::string::npos) {
+                std::string key = trim(line.substr(0, equals_pos));
+                std::string value_str = trim(line.substr(equals_pos + 1));
+                
+                if (!value_str.empty() && value_str.back() == ';') {
+                    value_str.pop_back();
+                }
+
+                if (key == "ASYNC_LEARNER") params.ASYNC_LEARNER = std::stoi(value_str);
+                else if (key == "PUBLISH_INTERVAL") params.PUBLISH_INTERVAL = std::stoi(value_str);
+                else if (key == "TRANSITION_QUEUE_CAPACITY") params.TRANSITION_QUEUE_CAPACITY = std::stoi(value_str);
+            }
+        }
+    }
+}
+
 // Function to parse buffer capacity
 void parse_buffer_capacity_impl(const std::string& file_path, int& capacity) {
     std::ifstream file(file_path);
@@ -259,4 +347,24 @@ namespace IO_FRONTEND {
         }
     }
 
+    bool parse_per_params(const std::string& param_file_path, PER_Params& per_params) {
+        try {
+            parse_per_params_impl(param_file_path, per_params);
+            return true;
+        } catch (const std::exception& e) {
+            std::cerr << "Error parsing PER parameters: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
+    bool parse_learner_params(const std::string& param_file_path, Learner_Params& learner_params) {
+        try {
+            parse_learner_params_impl(param_file_path, learner_params);
+            return true;
+        } catch (const std::exception& e) {
+            std::cerr << "Error parsing learner parameters: " << e.what() << std::endl;
+            return false;
+        }
+    }
+
 } // namespace IO_FRONTEND
\ No newline at end of file
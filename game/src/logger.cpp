@@ -1,7 +1,14 @@
 #include <logger.h>
 #include <iomanip>
-#include <ctime>
 #include <sstream>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+
+static_assert(LOGGER_RECORD_SIZE % 64 == 0, "log records are cache-line sized");
+static_assert((LOGGER_RING_SIZE & (LOGGER_RING_SIZE - 1)) == 0, "LOGGER_RING_SIZE must be a power of two");
 
 Logger& Logger::getInstance() {
     static Logger instance;
@@ -16,23 +23,84 @@ void Logger::init(const std::string& filename) {
         if (!m_logFile.is_open()) {
             throw std::runtime_error("Failed to open log file");
         }
-        initialized = true;
         m_logFile << "\n\n----- Log Session Started -----\n";
+
+        m_ring.reset(new Record[LOGGER_RING_SIZE]);
+        for (size_t i = 0; i < LOGGER_RING_SIZE; ++i) {
+            m_ring[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        m_writer = std::thread(&Logger::writerLoop, this);
+        initialized = true;
     }
 }
 
 Logger::~Logger() {
+    if (m_writer.joinable()) {
+        m_stop.store(true, std::memory_order_release);
+        m_writer.join();
+    }
     if (m_logFile.is_open()) {
         m_logFile.close();
     }
 }
 
-void Logger::log(LogType level, const std::string& message) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+// Reserve the next cell of the ring, waiting for the writer if it is full
+Logger::Record* Logger::claim(size_t& pos) {
     if (!initialized) {
         throw std::runtime_error("Logger not initialized");
     }
-    m_logFile << "[" << getCurrentTime() << "] [" << typeToString(level) << "] " << message << "\n";
+
+    pos = m_enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        Record& record = m_ring[pos & (LOGGER_RING_SIZE - 1)];
+        size_t seq = record.sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+        if (diff == 0) {
+            if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                return &record;
+            }
+        } else if (diff < 0) {
+            // full, the writer hasn't consumed this cell yet
+            std::this_thread::yield();
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        } else {
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::publish(Record* record, size_t pos) {
+    record->sequence.store(pos + 1, std::memory_order_release);
+}
+
+void Logger::log(LogType level, const std::string& message) {
+    size_t pos;
+    Record* record = claim(pos);
+
+    record->time = std::time(nullptr);
+    record->level = level;
+    record->length = static_cast<uint16_t>(std::min(message.size(), sizeof(record->text)));
+    std::memcpy(record->text, message.data(), record->length);
+
+    publish(record, pos);
+}
+
+void Logger::logf(LogType level, const char* format, ...) {
+    size_t pos;
+    Record* record = claim(pos);
+
+    record->time = std::time(nullptr);
+    record->level = level;
+
+    va_list args;
+    va_start(args, format);
+    int n = std::vsnprintf(record->text, sizeof(record->text), format, args);
+    va_end(args);
+    record->length = static_cast<uint16_t>(std::clamp<int>(n, 0, sizeof(record->text) - 1));
+
+    publish(record, pos);
 }
 
 void Logger::debug(const std::string& message) {
@@ -50,16 +118,69 @@ void Logger::error(const std::string& message) {
     log(LogType::ERROR, message);
 }
 
+void Logger::flush() {
+    if (!initialized) {
+        return;
+    }
+    size_t target = m_enqueue_pos.load(std::memory_order_acquire);
+    while (m_dequeue_pos.load(std::memory_order_acquire) < target) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+}
+
+// Write out every published record in order, returns how many were written
+size_t Logger::drain() {
+    size_t written = 0;
+    size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+
+    for (;;) {
+        Record& record = m_ring[pos & (LOGGER_RING_SIZE - 1)];
+        if (record.sequence.load(std::memory_order_acquire) != pos + 1) {
+            break; // not published yet
+        }
+
+        m_logFile << "[" << formatTime(record.time) << "] [" << typeToString(record.level) << "] ";
+        m_logFile.write(record.text, record.length);
+        m_logFile << "\n";
+
+        // hand the cell back to producers for the next lap of the ring
+        record.sequence.store(pos + LOGGER_RING_SIZE, std::memory_order_release);
+        pos++;
+        written++;
+    }
+
+    if (written > 0) {
+        m_logFile.flush();
+        m_dequeue_pos.store(pos, std::memory_order_release);
+    }
+    return written;
+}
+
+void Logger::writerLoop() {
+    for (;;) {
+        if (drain() > 0) {
+            continue;
+        }
+        if (m_stop.load(std::memory_order_acquire)) {
+            drain();
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
 
-std::string Logger::getCurrentTime() {
-    auto now = std::time(nullptr);
-    auto tm = *std::localtime(&now);
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+const std::string& Logger::formatTime(std::time_t time) {
+    if (time != m_last_time || m_last_time_str.empty()) {
+        auto tm = *std::localtime(&time);
+        std::ostringstream oss;
+        oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
+        m_last_time = time;
+        m_last_time_str = oss.str();
+    }
+    return m_last_time_str;
 }
 
-std::string Logger::typeToString(LogType level) {
+const char* Logger::typeToString(LogType level) {
     switch(level) {
         case LogType::DEBUG:   return "DEBUG";
         case LogType::INFO:    return "INFO";
@@ -67,4 +188,4 @@ std::string Logger::typeToString(LogType level) {
         case LogType::ERROR:   return "ERROR";
         default:                return "UNKNOWN";
     }
-}
\ No newline at end of file
+}
@@ -10,6 +10,7 @@
 #include <game.h>
 #include <logger.h>
 #include <stats.h>
+#include <metrics.h>
 
 #define WINDOW_WIDTH 800
 #define WINDOW_HEIGHT 600
@@ -21,6 +22,7 @@
 
 int main(int argc, char* argv[]) {
     Logger::getInstance().init("system.log");
+    Metrics::getInstance().init("metrics.bin");
     Game game;
     game.run();
 
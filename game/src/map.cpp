@@ -2,79 +2,144 @@
 #include <random>
 #include <tuple>
 #include <iostream>
+#include <algorithm>
 
-Map::Map(int w, int h) : width(w), height(h) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distrib(0, 9999);
+Map::Map(int w, int h, int sectors_x, int sectors_y) :
+    width(w), height(h), sectors_x(std::max(1, sectors_x)), sectors_y(std::max(1, sectors_y)) {
+    sector_food_counts.resize(this->sectors_x * this->sectors_y, 0.0);
 
+    bucket_cols = (width + FOOD_BUCKET_SIZE - 1) / FOOD_BUCKET_SIZE;
+    bucket_rows = (height + FOOD_BUCKET_SIZE - 1) / FOOD_BUCKET_SIZE;
+    food_buckets.resize(bucket_cols * bucket_rows);
 
-    grid = new Sprite**[height];
+    cells.resize(static_cast<size_t>(width) * height, EMPTY);
+    food_tree.resize(static_cast<size_t>(width + 1) * (height + 1), 0);
+    wall_sat.resize(static_cast<size_t>(width + 1) * (height + 1), 0);
 
-    int p = 20; // percentage of food in the map
-    int threshold = int( (p/100.0) * 10000 );
+    generate(100); // 1% of the cells hold food on the first map
+}
 
+void Map::reset() {
+    generate(6);
+}
+
+void Map::generate(int food_per_10000) {
+    clearFoodIndex();
+    std::fill(sector_food_counts.begin(), sector_food_counts.end(), 0.0);
+    food_count = 0;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> distrib(0, 9999);
 
     for (int i = 0; i < height; ++i) {
-        grid[i] = new Sprite*[width];
+        uint8_t* row = &cells[static_cast<size_t>(i) * width];
         for (int j = 0; j < width; ++j) {
             if (i == 0 || i == height - 1 || j == 0 || j == width - 1) {
-                grid[i][j] = new Wall(j, i); // Set borders as walls
+                row[j] = WALL; // Set borders as walls
             }
-            else if (distrib(gen) < 100) { // Randomly place food
-                grid[i][j] = new Food(j, i);
+            else if (distrib(gen) < food_per_10000) { // Randomly place food
+                row[j] = FOOD;
+                addFoodToIndex(j, i);
+                sector_food_counts[getSector(j, i)]++;
                 food_count++;
             }
             else {
-                grid[i][j] = nullptr; // Empty cell
+                row[j] = EMPTY;
             }
-
         }
     }
+
+    buildCountTables();
 }
 
-void Map::reset() {
+void Map::buildCountTables() {
+    const size_t stride = width + 1;
     for (int i = 0; i < height; ++i) {
+        const uint8_t* row = &cells[static_cast<size_t>(i) * width];
+        int32_t wall_row_sum = 0;
         for (int j = 0; j < width; ++j) {
-            delete grid[i][j];  // Delete individual Sprite objects
+            wall_row_sum += (row[j] == WALL);
+            size_t idx = (i + 1) * stride + (j + 1);
+            wall_sat[idx] = wall_sat[idx - stride] + wall_row_sum;
+            food_tree[idx] = (row[j] == FOOD);
         }
-        delete[] grid[i];  // Delete row array
     }
-    delete[] grid;
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> distrib(0, 9999);
 
-    grid = new Sprite**[height];
-    for (int i = 0; i < height; ++i) {
-        grid[i] = new Sprite*[width];
-        for (int j = 0; j < width; ++j) {
-            if (i == 0 || i == height - 1 || j == 0 || j == width - 1) {
-                grid[i][j] = new Wall(j, i); // Set borders as walls
-            }
-            else if (distrib(gen) < 6) { // Randomly place food
-                grid[i][j] = new Food(j, i);
-                food_count++;
-            }
-            else {
-                grid[i][j] = nullptr; // Empty cell
+    // O(W * H) Fenwick build: every node passes its sum on to its parent, first along the
+    // rows, then along the columns
+    for (int i = 1; i <= height; ++i) {
+        int32_t* row = &food_tree[i * stride];
+        for (int j = 1; j <= width; ++j) {
+            int parent = j + (j & -j);
+            if (parent <= width) {
+                row[parent] += row[j];
             }
+        }
+    }
+    for (int i = 1; i <= height; ++i) {
+        int parent = i + (i & -i);
+        if (parent > height) {
+            continue;
+        }
+        const int32_t* row = &food_tree[i * stride];
+        int32_t* parent_row = &food_tree[parent * stride];
+        for (int j = 1; j <= width; ++j) {
+            parent_row[j] += row[j];
+        }
+    }
+}
 
+void Map::removeFoodFromCounts(int x, int y) {
+    const size_t stride = width + 1;
+    for (int i = y + 1; i <= height; i += i & -i) {
+        int32_t* row = &food_tree[i * stride];
+        for (int j = x + 1; j <= width; j += j & -j) {
+            row[j]--;
         }
     }
 }
 
-Map::~Map() {
-    for (int i = 0; i < height; ++i) {
-        delete[] grid[i];
+int Map::foodPrefix(int x, int y) const {
+    const size_t stride = width + 1;
+    int sum = 0;
+    for (int i = y; i > 0; i -= i & -i) {
+        const int32_t* row = &food_tree[i * stride];
+        for (int j = x; j > 0; j -= j & -j) {
+            sum += row[j];
+        }
     }
-    delete[] grid;
+    return sum;
+}
+
+int Map::wallRectSum(int xmin, int ymin, int xmax, int ymax) const {
+    const size_t stride = width + 1;
+    return wall_sat[(ymax + 1) * stride + (xmax + 1)]
+         - wall_sat[ymin * stride + (xmax + 1)]
+         - wall_sat[(ymax + 1) * stride + xmin]
+         + wall_sat[ymin * stride + xmin];
+}
+
+int Map::foodRectSum(int xmin, int ymin, int xmax, int ymax) const {
+    return foodPrefix(xmax + 1, ymax + 1)
+         - foodPrefix(xmin, ymax + 1)
+         - foodPrefix(xmax + 1, ymin)
+         + foodPrefix(xmin, ymin);
+}
+
+void Map::clearFoodIndex() {
+    for (auto& bucket : food_buckets) {
+        bucket.clear();
+    }
+}
+
+void Map::addFoodToIndex(int x, int y) {
+    food_buckets[(y / FOOD_BUCKET_SIZE) * bucket_cols + (x / FOOD_BUCKET_SIZE)].push_back(y * width + x);
 }
 
 void Map::addOrganism(int x, int y, Genome genome) {
-    if (grid[y][x] == nullptr) {
-        grid[y][x] = new Organism(x, y, genome);
+    if (cellAt(x, y) == EMPTY) {
+        cells[static_cast<size_t>(y) * width + x] = ORGANISM;
     }
 }
 
@@ -92,14 +157,21 @@ void Map::organismCollisionFood(Sprite* sprite_org) {
     organism->getPosition(orgX, orgY);
     orgRadius = organism->getGenome().size;
 
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            if (grid[i][j] && grid[i][j]->getType() == FOOD) {
-                Food* food = static_cast<Food*>(grid[i][j]);
-                int foodX, foodY, foodRadius;
+    // Only buckets overlapping the organism's bounding box can hold food within reach
+    int reach = orgRadius + FOOD_SIZE;
+    int xmin = std::max(0, orgX - reach);
+    int xmax = std::min(width - 1, orgX + reach);
+    int ymin = std::max(0, orgY - reach);
+    int ymax = std::min(height - 1, orgY + reach);
+    if (xmin > xmax || ymin > ymax) return;
 
-                food->getPosition(foodX, foodY);
-                foodRadius = FOOD_SIZE;
+    for (int by = ymin / FOOD_BUCKET_SIZE; by <= ymax / FOOD_BUCKET_SIZE; ++by) {
+        for (int bx = xmin / FOOD_BUCKET_SIZE; bx <= xmax / FOOD_BUCKET_SIZE; ++bx) {
+            std::vector<int>& bucket = food_buckets[by * bucket_cols + bx];
+
+            for (size_t k = 0; k < bucket.size();) {
+                int foodX = bucket[k] % width;
+                int foodY = bucket[k] / width;
 
                 // Calculate distance between centers
                 int dx = orgX - foodX;
@@ -107,14 +179,20 @@ void Map::organismCollisionFood(Sprite* sprite_org) {
                 int distanceSq = dx * dx + dy * dy;
 
                 // Compare with sum of radii
-                int radiusSum = orgRadius + foodRadius;
-                if (distanceSq <= radiusSum * radiusSum) {
+                if (distanceSq <= reach * reach) {
                     // Collision detected!
-                    delete grid[i][j];
-                    grid[i][j] = nullptr;
+                    cells[bucket[k]] = EMPTY;
+                    removeFoodFromCounts(foodX, foodY);
                     food_count--;
+                    sector_food_counts[getSector(foodX, foodY)]--;
                     organism->eat();
                     eating = true; // Set eating flag
+
+                    // swap-remove, the bucket is unordered
+                    bucket[k] = bucket.back();
+                    bucket.pop_back();
+                } else {
+                    ++k;
                 }
             }
         }
@@ -125,15 +203,13 @@ bool Map::isWall(int x, int y) const {
     // Out‑of‑bounds counts as a wall
     if (x < 0 || x >= width || y < 0 || y >= height)
         return true;
-    Sprite* s = grid[y][x];
-    return (s != nullptr && s->getType() == WALL);
+    return cellAt(x, y) == WALL;
 }
 
 int Map::getWallPosX(int x, int y) const {
     if (x < 0 || x >= width || y < 0 || y >= height)
         return -1; // Invalid position
-    Sprite* s = grid[y][x];
-    if (s != nullptr && s->getType() == WALL) {
+    if (cellAt(x, y) == WALL) {
         return x;
     }
     return -1; // No wall at this position
@@ -142,19 +218,22 @@ int Map::getWallPosX(int x, int y) const {
 int Map::getWallPosY(int x, int y) const {
     if (x < 0 || x >= width || y < 0 || y >= height)
         return -1; // Invalid position
-    Sprite* s = grid[y][x];
-    if (s != nullptr && s->getType() == WALL) {
+    if (cellAt(x, y) == WALL) {
         return y;
     }
     return -1; // No wall at this position
 }
 
+#ifndef HEADLESS
 void Map::draw_map(SDL_Renderer* renderer) {
+    // Sprites only exist for the duration of their draw call, the world state is the cell grid
     for (int i = 0; i < height; ++i) {
+        const uint8_t* row = &cells[static_cast<size_t>(i) * width];
         for (int j = 0; j < width; ++j) {
-            Sprite* cell = grid[i][j];
-            if (cell != nullptr) {
-                cell->draw(renderer);
+            if (row[j] == WALL) {
+                Wall(j, i).draw(renderer);
+            } else if (row[j] == FOOD) {
+                Food(j, i).draw(renderer);
             }
         }
     }
@@ -176,6 +255,7 @@ void Map::drawVision(SDL_Renderer* renderer) const {
 
     SDL_RenderDrawRect(renderer, &rect);*/
 }
+#endif
 
 std::tuple<int, bool, int> Map::getVision(int x, int y,
                                         Direction facing,
@@ -225,59 +305,46 @@ std::tuple<int, bool, int> Map::getVision(int x, int y,
 
     org_vision = std::make_tuple(xmin, ymin, xmax, ymax);
 
-    bool sawWall = false;
     int foodCount = 0;
-    int wall_distance = -1; // distance to the first wall encountered, -1 if no wall
-
-    // scan box
-    for (int j = xmin; j <= xmax; ++j) {
-        for (int k = ymin; k <= ymax; ++k) {
-            if (j < 0 || j >= width || k < 0 || k >= height) {
-                sawWall = true;
-                if (wall_distance == -1) {
-                    wall_distance = std::abs(j - x) + std::abs(k - y);
-                }
-                continue;
-            }
-            auto* cell = grid[k][j];
-            if (!cell) continue;
-            if (cell->getType() == WALL) {
-                sawWall = true;
-            } else if (cell->getType() == FOOD) {
-                ++foodCount;
-            }
-        }
+    bool sawWall = false;
+    int wall_distance = -1; // distance to the first out-of-bounds cell, -1 if none
+
+    // food and wall counts over the in-bounds part of the box
+    int cxmin = std::max(xmin, 0), cxmax = std::min(xmax, width - 1);
+    int cymin = std::max(ymin, 0), cymax = std::min(ymax, height - 1);
+    if (cxmin <= cxmax && cymin <= cymax) {
+        foodCount = foodRectSum(cxmin, cymin, cxmax, cymax);
+        sawWall = wallRectSum(cxmin, cymin, cxmax, cymax) > 0;
     }
 
-    return std::make_tuple(foodCount, sawWall, wall_distance);
-}
-
-std::vector<double> Map::getFoodCounts() const {
-    std::vector<double> food_counts; // 3x3 grid around the organism
+    // First out-of-bounds cell in column-major scan order (x outer, y inner), i.e. the
+    // cell a scan of the box from (xmin, ymin) would hit first
+    int wall_j = 0, wall_k = 0;
+    bool outOfBounds = true;
+    if (xmin < 0 || xmin >= width || ymin < 0 || ymin >= height) {
+        wall_j = xmin; wall_k = ymin;
+    } else if (ymax >= height) {
+        wall_j = xmin; wall_k = height;
+    } else if (xmax >= width) {
+        wall_j = width; wall_k = ymin;
+    } else {
+        outOfBounds = false;
+    }
 
-    food_counts.resize(9, 0); // Initialize with 0s
+    if (outOfBounds) {
+        sawWall = true;
+        wall_distance = std::abs(wall_j - x) + std::abs(wall_k - y);
+    }
 
-    if (width == 0 || height == 0) return food_counts; // Handle empty map case
+    return std::make_tuple(foodCount, sawWall, wall_distance);
+}
 
+uint32_t Map::getSector(int x, int y) const {
     // Calculate sector sizes safely
-    const int sector_width = std::max(1, width / 3);
-    const int sector_height = std::max(1, height / 3);
-
-    for (int i = 0; i < height; ++i) {
-        for (int j = 0; j < width; ++j) {
-            // Calculate sector with bounds checking
-            int sector_x = std::min(j / sector_width, 2);
-            int sector_y = std::min(i / sector_height, 2);
-            int sector_index = sector_y * 3 + sector_x;
-            
-            if (sector_index >= 0 && sector_index < 9) {
-                if (grid[i][j] != nullptr && grid[i][j]->getType() == FOOD) {
-                    food_counts[sector_index]++;
-                }
-            }
-        }
-    }
+    const int sector_width = std::max(1, width / sectors_x);
+    const int sector_height = std::max(1, height / sectors_y);
 
-
-    return food_counts;
-}
\ No newline at end of file
+    int sector_x = std::clamp(x / sector_width, 0, sectors_x - 1);
+    int sector_y = std::clamp(y / sector_height, 0, sectors_y - 1);
+    return sector_y * sectors_x + sector_x;
+}
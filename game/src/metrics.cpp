@@ -0,0 +1,137 @@
+#include <metrics.h>
+#include <iostream>
+#include <limits>
+#include <cstring>
+
+#define METRICS_BUFFER_RECORDS 4096
+
+Metrics& Metrics::getInstance() {
+    static Metrics instance;
+    return instance;
+}
+
+bool Metrics::init(const std::string& filename) {
+    if (m_enabled) {
+        return true;
+    }
+
+    m_file.open(filename, std::ios::binary | std::ios::trunc);
+    m_index.open(filename + ".idx", std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open() || !m_index.is_open()) {
+        std::cerr << "Failed to open metrics file: " << filename << std::endl;
+        return false;
+    }
+
+    MetricsFileHeader header = {{'L', 'I', 'F', 'E', 'M', 'E', 'T', '\0'}, METRICS_VERSION, sizeof(StepMetrics)};
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    MetricsFileHeader index_header = {{'L', 'I', 'F', 'E', 'I', 'D', 'X', '\0'}, METRICS_VERSION, sizeof(EpisodeIndexEntry)};
+    m_index.write(reinterpret_cast<const char*>(&index_header), sizeof(index_header));
+
+    m_buffer.reserve(METRICS_BUFFER_RECORDS);
+    clearPending();
+    m_enabled = true;
+    return true;
+}
+
+Metrics::~Metrics() {
+    flush();
+}
+
+void Metrics::clearPending() {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::memset(&m_pending, 0, sizeof(m_pending));
+    for (float& q : m_pending.q_values) {
+        q = nan;
+    }
+    m_pending.temperature = nan;
+    m_pending.extrinsic_reward = nan;
+    m_pending.total_reward = nan;
+    m_pending.beta = nan;
+    m_pending.z_score = nan;
+    m_pending.intrinsic_mse = nan;
+}
+
+void Metrics::recordAction(const double* q_values, int action, double temperature) {
+    if (!m_enabled) {
+        return;
+    }
+    for (int i = 0; i < 4; ++i) {
+        m_pending.q_values[i] = static_cast<float>(q_values[i]);
+    }
+    m_pending.action = static_cast<uint8_t>(action);
+    m_pending.temperature = static_cast<float>(temperature);
+}
+
+void Metrics::recordIntrinsic(double mse, double z_score) {
+    if (!m_enabled) {
+        return;
+    }
+    m_pending.intrinsic_mse = static_cast<float>(mse);
+    m_pending.z_score = static_cast<float>(z_score);
+}
+
+void Metrics::recordReward(double extrinsic, double total, double beta) {
+    if (!m_enabled) {
+        return;
+    }
+    m_pending.extrinsic_reward = static_cast<float>(extrinsic);
+    m_pending.total_reward = static_cast<float>(total);
+    m_pending.beta = static_cast<float>(beta);
+}
+
+void Metrics::commitStep(uint32_t episode, uint32_t step, uint16_t env, double energy) {
+    if (!m_enabled) {
+        return;
+    }
+    m_pending.episode = episode;
+    m_pending.step = step;
+    m_pending.env = env;
+    m_pending.energy = static_cast<float>(energy);
+
+    m_buffer.push_back(m_pending);
+    m_records++;
+    clearPending();
+
+    if (m_buffer.size() >= METRICS_BUFFER_RECORDS) {
+        m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size() * sizeof(StepMetrics));
+        m_buffer.clear();
+    }
+}
+
+void Metrics::beginEpisode(uint32_t episode) {
+    if (!m_enabled) {
+        return;
+    }
+    m_episode_start[episode] = m_records;
+}
+
+void Metrics::endEpisode(uint32_t episode, uint32_t length) {
+    if (!m_enabled) {
+        return;
+    }
+    EpisodeIndexEntry entry;
+    entry.episode = episode;
+    entry.length = length;
+    auto it = m_episode_start.find(episode);
+    entry.first_record = it != m_episode_start.end() ? it->second : 0;
+    entry.end_record = m_records;
+    if (it != m_episode_start.end()) {
+        m_episode_start.erase(it);
+    }
+
+    m_index.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    flush(); // episode boundaries are a natural checkpoint for readers
+}
+
+void Metrics::flush() {
+    if (!m_enabled) {
+        return;
+    }
+    if (!m_buffer.empty()) {
+        m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size() * sizeof(StepMetrics));
+        m_buffer.clear();
+    }
+    m_file.flush();
+    m_index.flush();
+}
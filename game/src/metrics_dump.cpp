@@ -0,0 +1,127 @@
+#include <metrics.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+
+// Converts metrics.bin (see metrics.h) to CSV on stdout, or prints the episode index.
+//   metrics_dump metrics.bin                per-step CSV
+//   metrics_dump metrics.bin --episode N    only episode N, using the index to seek
+//   metrics_dump metrics.bin --index        one line per finished episode
+
+static bool readHeader(std::ifstream& file, const char* magic, uint32_t record_size, const std::string& path) {
+    MetricsFileHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::strncmp(header.magic, magic, 8) != 0) {
+        std::cerr << "Not a metrics file: " << path << std::endl;
+        return false;
+    }
+    if (header.version != METRICS_VERSION || header.record_size != record_size) {
+        std::cerr << "Unsupported metrics version " << header.version << " (record size " << header.record_size << ") in " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool readIndex(const std::string& path, std::vector<EpisodeIndexEntry>& entries) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Could not open index: " << path << std::endl;
+        return false;
+    }
+    if (!readHeader(file, "LIFEIDX", sizeof(EpisodeIndexEntry), path)) {
+        return false;
+    }
+    EpisodeIndexEntry entry;
+    while (file.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+        entries.push_back(entry);
+    }
+    return true;
+}
+
+static void printRecord(const StepMetrics& r) {
+    std::printf("%u,%u,%u,%u,%g,%g,%g,%g,%g,%g,%g,%g,%g,%g,%g\n",
+        r.episode, r.step, r.env, r.action,
+        r.q_values[0], r.q_values[1], r.q_values[2], r.q_values[3],
+        r.temperature, r.energy, r.extrinsic_reward, r.total_reward, r.beta, r.z_score, r.intrinsic_mse);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " metrics.bin [--episode N | --index]" << std::endl;
+        return 1;
+    }
+    std::string path = argv[1];
+    std::string mode = argc > 2 ? argv[2] : "";
+
+    if (mode == "--index") {
+        std::vector<EpisodeIndexEntry> entries;
+        if (!readIndex(path + ".idx", entries)) {
+            return 1;
+        }
+        std::printf("episode,length,first_record,end_record\n");
+        for (const auto& e : entries) {
+            std::printf("%u,%u,%llu,%llu\n", e.episode, e.length,
+                static_cast<unsigned long long>(e.first_record), static_cast<unsigned long long>(e.end_record));
+        }
+        return 0;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "Could not open metrics file: " << path << std::endl;
+        return 1;
+    }
+    if (!readHeader(file, "LIFEMET", sizeof(StepMetrics), path)) {
+        return 1;
+    }
+
+    // default: every record
+    long long episode = -1;
+    uint64_t first = 0, end = UINT64_MAX;
+    if (mode == "--episode" && argc > 3) {
+        episode = std::stoll(argv[3]);
+        std::vector<EpisodeIndexEntry> entries;
+        if (!readIndex(path + ".idx", entries)) {
+            return 1;
+        }
+        bool found = false;
+        for (const auto& e : entries) {
+            if (e.episode == episode) {
+                first = e.first_record;
+                end = e.end_record;
+                found = true;
+            }
+        }
+        if (!found) {
+            std::cerr << "Episode " << episode << " is not in the index" << std::endl;
+            return 1;
+        }
+        file.seekg(sizeof(MetricsFileHeader) + first * sizeof(StepMetrics));
+    } else if (!mode.empty()) {
+        std::cerr << "Unknown option: " << mode << std::endl;
+        return 1;
+    }
+
+    std::printf("episode,step,env,action,q0,q1,q2,q3,temperature,energy,extrinsic_reward,total_reward,beta,z_score,intrinsic_mse\n");
+
+    std::vector<StepMetrics> chunk(4096);
+    uint64_t pos = first;
+    while (pos < end && file) {
+        uint64_t want = std::min<uint64_t>(chunk.size(), end - pos);
+        file.read(reinterpret_cast<char*>(chunk.data()), want * sizeof(StepMetrics));
+        uint64_t got = file.gcount() / sizeof(StepMetrics);
+        for (uint64_t i = 0; i < got; ++i) {
+            if (episode < 0 || chunk[i].episode == episode) {
+                printRecord(chunk[i]);
+            }
+        }
+        pos += got;
+        if (got < want) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -57,6 +57,7 @@ bool Organism::move(int dx, int dy) {
     return true;
 }
 
+#ifndef HEADLESS
 void Organism::draw(SDL_Renderer* renderer) {
     // Draw the organism as a filled circle
     // color based on gender
@@ -69,6 +70,7 @@ void Organism::draw(SDL_Renderer* renderer) {
 
     drawCircle(renderer, x, y, m_genome.size, true);
 }
+#endif
 
 void Organism::eat() {
     foods_eaten++;
@@ -89,10 +91,4 @@ Direction Organism::getDirection() const { return m_direction; }
 
 Genome Organism::getGenome() const {
     return m_genome;
-}
-
-uint32_t Organism::getSector(int width, int height) {
-    int sector_x = x / (width / 3);
-    int sector_y = y / (height / 3);
-    return sector_y * 3 + sector_x;
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <policy.h>
 #include <logger.h>
+#include <metrics.h>
 #include <sstream>
 
 // Policy will help agent decide what action to take
@@ -12,7 +13,7 @@ EpsilonGreedyPolicy::EpsilonGreedyPolicy(double epsilon, double decay_rate, doub
 }
 
 
-Action EpsilonGreedyPolicy::selectAction(uint32_t id, uint32_t nn_type, State state) {
+Action EpsilonGreedyPolicy::selectAction(nn_network* network, State state) {
     double n = unif(rng);
 
     std::vector<Action> actions;
@@ -29,11 +30,12 @@ Action EpsilonGreedyPolicy::selectAction(uint32_t id, uint32_t nn_type, State st
 
 
         // Prepare input data for the neural network
-        double* input_data = prepareInputData(state, false, {}, 0);
+        m_input_data.resize(dqn_parameters.DQN_INPUT_DIM);
+        prepareInputData(state, m_input_data.data());
 
-        double* q_values = new double[4];
+        double* q_values = m_q_values;
 
-        predict_nn(id, nn_type, input_data, q_values, 1); // batch size should be 1 therefore we only expect 1 sample output
+        nn_predict(network, m_input_data.data(), q_values, 1); // batch size should be 1 therefore we only expect 1 sample output
 
         double max_q_value = q_values[0];
         int best_action_index = 0;
@@ -55,17 +57,19 @@ Action EpsilonGreedyPolicy::selectAction(uint32_t id, uint32_t nn_type, State st
             m_epsilon = m_min_epsilon;
         }
 
-        //delete[] q_values;
-
         return action;
     }
     
 }
 
 std::vector<double> BoltzmannPolicy::computeProbabilities(double* q_values) {
+    std::vector<double> probabilities(4);
+    computeProbabilities(q_values, probabilities.data());
+    return probabilities;
+}
+
+void BoltzmannPolicy::computeProbabilities(const double* q_values, double* probs) {
     const int num_actions = 4;
-    std::vector<double> probabilities;
-    probabilities.reserve(num_actions);
 
     // 1. Find maximum Q-value for numerical stability
     double max_q = q_values[0];
@@ -80,67 +84,59 @@ std::vector<double> BoltzmannPolicy::computeProbabilities(double* q_values) {
     for (int i = 0; i < num_actions; ++i) {
         // Apply temperature scaling and exponentiate
         double exp_val = std::exp((q_values[i] - max_q) / m_temperature);
-        probabilities.push_back(exp_val);
+        probs[i] = exp_val;
         sum_exp += exp_val;
     }
 
     // 3. Normalize to get probabilities
-    for (double& prob : probabilities) {
-        prob /= sum_exp;
+    for (int i = 0; i < num_actions; ++i) {
+        probs[i] /= sum_exp;
     }
-
-    return probabilities;
 }
 
     // Select action based on softmax probabilities
 int BoltzmannPolicy::selectAction(double* q_values) {
-    std::vector<double> probs = computeProbabilities(q_values);
-        
-    // Create cumulative distribution
-    std::vector<double> cumulative;
-    cumulative.reserve(probs.size());
-    cumulative.push_back(probs[0]);
-        
-    for (size_t i = 1; i < probs.size(); ++i) {
-        cumulative.push_back(cumulative.back() + probs[i]);
-    }
-        
-    // Sample from distribution
+    const int num_actions = 4;
+    double probs[num_actions];
+    computeProbabilities(q_values, probs);
+
+    // Sample from the cumulative distribution
     double r = uniform_dist(rng);
-    for (size_t i = 0; i < cumulative.size(); ++i) {
-        if (r <= cumulative[i]) {
-            return static_cast<int>(i);
+    double cumulative = 0.0;
+    for (int i = 0; i < num_actions; ++i) {
+        cumulative += probs[i];
+        if (r <= cumulative) {
+            return i;
         }
     }
 
-    std::ostringstream ss;
-    ss << "Boltzmann Policy Probs: [";
-    for (size_t i = 0; i < probs.size(); ++i) {
-        ss << probs[i] << (i+1<probs.size() ? ", " : "");
+    if constexpr (Logger::enabled(LogType::DEBUG)) {
+        std::ostringstream ss;
+        ss << "Boltzmann Policy Probs: [";
+        for (int i = 0; i < num_actions; ++i) {
+            ss << probs[i] << (i+1<num_actions ? ", " : "");
+        }
+        ss << "]"<<std::endl;
+        Logger::getInstance().log(LogType::DEBUG, ss.str());
     }
-    ss << "]"<<std::endl;
-    Logger::getInstance().log(LogType::DEBUG, ss.str());
         
     return 0;  // Fallback
 }
 // In your agent code:
-Action BoltzmannPolicy::selectAction(uint32_t id, uint32_t nn_type, State state) {
+Action BoltzmannPolicy::selectAction(nn_network* network, State state) {
     // verify that state is not null or inv
     // Prepare input data
-    double* input_data = prepareInputData(state, false, {}, 0);
-    
-    double* q_values = new double[4]; // Assuming 4 actions
-    // Get Q-values from neural network
-    predict_nn(id, nn_type, input_data, q_values, 1);
-    //delete[] input_data;
+    m_input_data.resize(dqn_parameters.DQN_INPUT_DIM);
+    prepareInputData(state, m_input_data.data());
 
+    // Get Q-values from neural network
+    nn_predict(network, m_input_data.data(), m_q_values, 1);
 
+    return chooseAction(m_q_values);
+}
 
-    Logger::getInstance().log(LogType::DEBUG, "Boltzmann Policy Q-Values: " + 
-        std::to_string(q_values[0]) + ", " + 
-        std::to_string(q_values[1]) + ", " + 
-        std::to_string(q_values[2]) + ", " + 
-        std::to_string(q_values[3]));
+Action BoltzmannPolicy::chooseAction(double* q_values) {
+    LOG_DEBUG("Boltzmann Policy Q-Values: %f, %f, %f, %f", q_values[0], q_values[1], q_values[2], q_values[3]);
     
     // Create action object
     Action action;
@@ -149,9 +145,8 @@ Action BoltzmannPolicy::selectAction(uint32_t id, uint32_t nn_type, State state)
     // Update temperature
     decayTemperature();
 
-    Logger::getInstance().log(LogType::DEBUG, "Selected Action: " + 
-        std::to_string(static_cast<int>(action.direction)) + 
-        " with Temperature: " + std::to_string(m_temperature));
+    LOG_DEBUG("Selected Action: %d with Temperature: %f", static_cast<int>(action.direction), m_temperature);
+    Metrics::getInstance().recordAction(q_values, static_cast<int>(action.direction), m_temperature);
 
     return action;
 }
@@ -165,6 +160,11 @@ void BoltzmannPolicy::decayTemperature() {
 }
 
 // Get current temperature
-double BoltzmannPolicy::getTemperature() {
+double BoltzmannPolicy::getTemperature() const {
     return m_temperature;
 }
+
+void BoltzmannPolicy::restoreState(double temperature, int decay_counter) {
+    m_temperature = std::max(m_min_temperature, temperature);
+    m_decay_counter = decay_counter;
+}
@@ -0,0 +1,257 @@
+#include <replay_buffer.h>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+
+ReplayBuffer::ReplayBuffer(size_t capacity, size_t state_dim, bool transitions) :
+    m_capacity(capacity),
+    m_state_dim(state_dim),
+    m_transitions(transitions) {
+
+    if (capacity == 0 || state_dim == 0) {
+        throw std::invalid_argument("Replay buffer capacity and state dimension must be positive");
+    }
+
+    m_states.resize(capacity * state_dim);
+
+    if (transitions) {
+        m_next_states.resize(capacity * state_dim);
+        m_actions.resize(capacity);
+        m_rewards.resize(capacity);
+        m_dones.resize(capacity);
+    }
+}
+
+void ReplayBuffer::enablePrioritized(double alpha, double priority_eps) {
+    if (m_size != 0) {
+        throw std::logic_error("Prioritized replay must be enabled on an empty buffer");
+    }
+
+    m_prioritized = true;
+    m_alpha = alpha;
+    m_priority_eps = priority_eps;
+    m_max_priority = 1.0;
+    m_priorities = SumTree(m_capacity);
+}
+
+void ReplayBuffer::enableEmbeddings(size_t embedding_dim) {
+    if (m_size != 0) {
+        throw std::logic_error("Embeddings must be enabled on an empty buffer");
+    }
+    if (embedding_dim == 0) {
+        throw std::invalid_argument("Embedding dimension must be positive");
+    }
+
+    m_embedding_dim = embedding_dim;
+    m_embeddings.resize(m_capacity * embedding_dim);
+    m_pending_embeddings = 0;
+}
+
+void ReplayBuffer::markEmbedded(size_t count) {
+    m_pending_embeddings -= std::min(count, m_pending_embeddings);
+}
+
+void ReplayBuffer::setEmbeddingVersion(uint64_t version) {
+    if (version != m_embedding_version) {
+        m_embedding_version = version;
+        m_pending_embeddings = m_size;
+    }
+}
+
+size_t ReplayBuffer::push() {
+    size_t slot = m_head;
+
+    if (m_prioritized) {
+        m_priorities.update(slot, m_max_priority);
+    }
+
+    m_head = (m_head + 1) % m_capacity;
+    if (m_size < m_capacity) {
+        m_size++;
+    }
+    if (m_embedding_dim != 0 && m_pending_embeddings < m_size) {
+        m_pending_embeddings++;
+    }
+
+    return slot;
+}
+
+void ReplayBuffer::setTransition(size_t slot, int action, double reward, bool done) {
+    m_actions[slot] = action;
+    m_rewards[slot] = reward;
+    m_dones[slot] = done ? 1.0 : 0.0;
+}
+
+void ReplayBuffer::sample(size_t batch_size, std::mt19937& gen, std::vector<size_t>& slots) const {
+    if (m_size == 0) {
+        throw std::runtime_error("Cannot sample from an empty replay buffer");
+    }
+
+    std::uniform_int_distribution<size_t> distrib(0, m_size - 1);
+
+    slots.resize(batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+        slots[i] = distrib(gen);
+    }
+}
+
+void ReplayBuffer::samplePrioritized(size_t batch_size, std::mt19937& gen, double beta,
+                                     std::vector<size_t>& slots, std::vector<double>& weights) const {
+    if (m_size == 0) {
+        throw std::runtime_error("Cannot sample from an empty replay buffer");
+    }
+
+    const double total = m_priorities.total();
+    const double segment = total / batch_size;
+    const double min_priority = m_priorities.min();
+
+    std::uniform_real_distribution<double> unif(0.0, 1.0);
+
+    slots.resize(batch_size);
+    weights.resize(batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+        double prefix = (i + unif(gen)) * segment;
+
+        // rounding can push the walk into the empty leaves past the filled part
+        size_t slot = std::min(m_priorities.find(prefix), m_size - 1);
+
+        slots[i] = slot;
+        // (N * P(i))^-beta normalized by the largest weight, that of the lowest priority
+        weights[i] = std::pow(m_priorities.get(slot) / min_priority, -beta);
+    }
+}
+
+void ReplayBuffer::updatePriorities(const std::vector<size_t>& slots, const std::vector<double>& td_errors) {
+    for (size_t i = 0; i < slots.size(); ++i) {
+        double priority = std::pow(std::abs(td_errors[i]) + m_priority_eps, m_alpha);
+        m_priorities.update(slots[i], priority);
+        m_max_priority = std::max(m_max_priority, priority);
+    }
+}
+
+void ReplayBuffer::gatherStates(const std::vector<size_t>& slots, double* out) const {
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const double* row = state(slots[i]);
+        std::copy(row, row + m_state_dim, out + i * m_state_dim);
+    }
+}
+
+void ReplayBuffer::gatherNextStates(const std::vector<size_t>& slots, double* out) const {
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const double* row = nextState(slots[i]);
+        std::copy(row, row + m_state_dim, out + i * m_state_dim);
+    }
+}
+
+void ReplayBuffer::gatherEmbeddings(const std::vector<size_t>& slots, double* out) const {
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const double* row = &m_embeddings[slots[i] * m_embedding_dim];
+        std::copy(row, row + m_embedding_dim, out + i * m_embedding_dim);
+    }
+}
+
+namespace {
+    // Fixed part of a streamed buffer, followed by the arrays for slots [0, size)
+    struct ReplayBufferHeader {
+        uint64_t capacity;
+        uint64_t state_dim;
+        uint64_t size;
+        uint64_t head;
+        uint32_t transitions;
+        uint32_t prioritized;
+        double max_priority;
+    };
+
+    template <typename T>
+    void write_array(std::ostream& out, const std::vector<T>& values, size_t count) {
+        out.write(reinterpret_cast<const char*>(values.data()), count * sizeof(T));
+    }
+
+    template <typename T>
+    void read_array(std::istream& in, std::vector<T>& values, size_t count) {
+        in.read(reinterpret_cast<char*>(values.data()), count * sizeof(T));
+    }
+}
+
+void ReplayBuffer::write(std::ostream& out) const {
+    ReplayBufferHeader header = {};
+    header.capacity = m_capacity;
+    header.state_dim = m_state_dim;
+    header.size = m_size;
+    header.head = m_head;
+    header.transitions = m_transitions ? 1 : 0;
+    header.prioritized = m_prioritized ? 1 : 0;
+    header.max_priority = m_max_priority;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    // slots [0, size) are the filled ones, the ring only wraps once it is full
+    write_array(out, m_states, m_size * m_state_dim);
+    if (m_transitions) {
+        write_array(out, m_next_states, m_size * m_state_dim);
+        write_array(out, m_actions, m_size);
+        write_array(out, m_rewards, m_size);
+        write_array(out, m_dones, m_size);
+    }
+    if (m_prioritized) {
+        std::vector<double> priorities(m_size);
+        for (size_t i = 0; i < m_size; ++i) {
+            priorities[i] = m_priorities.get(i);
+        }
+        write_array(out, priorities, m_size);
+    }
+
+    if (!out) {
+        throw std::runtime_error("Failed to write replay buffer");
+    }
+}
+
+void ReplayBuffer::read(std::istream& in) {
+    ReplayBufferHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        throw std::runtime_error("Replay buffer stream is truncated");
+    }
+    if (header.capacity != m_capacity || header.state_dim != m_state_dim ||
+        header.transitions != (m_transitions ? 1u : 0u) || header.size > m_capacity || header.head >= m_capacity) {
+        throw std::runtime_error("Saved replay buffer does not match this buffer's shape");
+    }
+
+    const size_t size = header.size;
+    m_size = 0;
+    m_head = 0;
+    m_pending_embeddings = 0;
+
+    read_array(in, m_states, size * m_state_dim);
+    if (m_transitions) {
+        read_array(in, m_next_states, size * m_state_dim);
+        read_array(in, m_actions, size);
+        read_array(in, m_rewards, size);
+        read_array(in, m_dones, size);
+    }
+
+    std::vector<double> priorities;
+    if (header.prioritized) {
+        priorities.resize(size);
+        read_array(in, priorities, size);
+    }
+    if (!in) {
+        throw std::runtime_error("Replay buffer stream is truncated");
+    }
+
+    if (m_prioritized) {
+        // a buffer saved without priorities gets the starting priority everywhere
+        m_max_priority = header.prioritized ? header.max_priority : 1.0;
+        m_priorities = SumTree(m_capacity);
+        for (size_t i = 0; i < size; ++i) {
+            m_priorities.update(i, header.prioritized ? priorities[i] : m_max_priority);
+        }
+    }
+
+    m_size = size;
+    m_head = header.head;
+    if (m_embedding_dim != 0) {
+        m_pending_embeddings = m_size;
+    }
+}
@@ -1,5 +1,6 @@
 #include <sprites.h>
 
+#ifndef HEADLESS
 void drawCircle(SDL_Renderer* renderer, int x_c, int y_c, int r, bool filled) {
     int x = 0;
     int y = r;
@@ -34,6 +35,7 @@ void drawCircle(SDL_Renderer* renderer, int x_c, int y_c, int r, bool filled) {
     }
 }
 
+#endif
 
 Sprite::Sprite(int x, int y, Color color, Type type) : x(x), y(y), color(color), m_type(type) {}
 
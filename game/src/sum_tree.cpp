@@ -0,0 +1,39 @@
+#include <sum_tree.h>
+#include <algorithm>
+#include <limits>
+
+SumTree::SumTree(size_t capacity) {
+    m_leaves = 1;
+    while (m_leaves < capacity) {
+        m_leaves <<= 1;
+    }
+
+    m_sums.assign(2 * m_leaves, 0.0);
+    m_mins.assign(2 * m_leaves, std::numeric_limits<double>::infinity());
+}
+
+void SumTree::update(size_t leaf, double priority) {
+    size_t node = m_leaves + leaf;
+    m_sums[node] = priority;
+    m_mins[node] = priority;
+
+    // walk up to the root, refreshing both aggregates
+    for (node /= 2; node >= 1; node /= 2) {
+        m_sums[node] = m_sums[2 * node] + m_sums[2 * node + 1];
+        m_mins[node] = std::min(m_mins[2 * node], m_mins[2 * node + 1]);
+    }
+}
+
+size_t SumTree::find(double prefix) const {
+    size_t node = 1;
+    while (node < m_leaves) {
+        size_t left = 2 * node;
+        if (prefix < m_sums[left]) {
+            node = left;
+        } else {
+            prefix -= m_sums[left];
+            node = left + 1;
+        }
+    }
+    return node - m_leaves;
+}
@@ -0,0 +1,54 @@
+#include <transition_queue.h>
+#include <stdexcept>
+
+TransitionQueue::TransitionQueue(size_t capacity, size_t state_dim, size_t rnd_dim) :
+    m_state_dim(state_dim),
+    m_rnd_dim(rnd_dim) {
+
+    if (capacity == 0 || state_dim == 0 || rnd_dim == 0) {
+        throw std::invalid_argument("Transition queue capacity and dimensions must be positive");
+    }
+
+    m_capacity = 1;
+    while (m_capacity < capacity) {
+        m_capacity <<= 1;
+    }
+    m_mask = m_capacity - 1;
+
+    m_states.resize(m_capacity * state_dim);
+    m_next_states.resize(m_capacity * state_dim);
+    m_rnd_inputs.resize(m_capacity * rnd_dim);
+    m_actions.resize(m_capacity);
+    m_rewards.resize(m_capacity);
+    m_dones.resize(m_capacity);
+}
+
+bool TransitionQueue::claim(size_t& slot) {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_cached_head == m_capacity) {
+        // looks full, refresh the consumer's position before giving up
+        m_cached_head = m_head.load(std::memory_order_acquire);
+        if (tail - m_cached_head == m_capacity) {
+            return false;
+        }
+    }
+    slot = tail & m_mask;
+    return true;
+}
+
+void TransitionQueue::publish() {
+    m_tail.store(m_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+bool TransitionQueue::front(size_t& slot) const {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+    slot = head & m_mask;
+    return true;
+}
+
+void TransitionQueue::pop() {
+    m_head.store(m_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
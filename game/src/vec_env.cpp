@@ -0,0 +1,106 @@
+#include <vec_env.h>
+#include <logger.h>
+
+VecEnv::VecEnv(int num_envs, Genome genome) :
+    m_boltzmann_policy(nullptr) {
+
+    if (num_envs < 1) {
+        throw std::invalid_argument("VecEnv needs at least one environment");
+    }
+
+    // Reserve up front: agents and envs keep pointers into these vectors
+    m_maps.reserve(num_envs);
+    m_organisms.reserve(num_envs);
+    m_agents.reserve(num_envs);
+    m_envs.reserve(num_envs);
+
+    for (int i = 0; i < num_envs; ++i) {
+        m_maps.emplace_back(MAP_WIDTH, MAP_HEIGHT);
+        // spawn position is overwritten by Environment::reset
+        m_organisms.emplace_back(MAP_WIDTH / 2, MAP_HEIGHT / 2, genome);
+    }
+    for (int i = 0; i < num_envs; ++i) {
+        m_agents.emplace_back(&m_organisms[i]);
+    }
+    for (int i = 0; i < num_envs; ++i) {
+        m_envs.emplace_back(&m_maps[i], &m_organisms[i], &m_agents[i], nullptr);
+        m_envs.back().setId(static_cast<uint16_t>(i));
+    }
+
+    m_episode_lengths.resize(num_envs, 0);
+    m_finished.reserve(num_envs);
+}
+
+VecEnv::~VecEnv() {
+    if (m_boltzmann_policy) {
+        delete m_boltzmann_policy;
+    }
+}
+
+void VecEnv::setTrainer(Trainer* trainer) {
+    m_trainer = trainer;
+    for (auto& env : m_envs) {
+        env.setTrainer(trainer);
+    }
+}
+
+void VecEnv::setPolicy(PolicyType policy_type) {
+    if (!config::load()) {
+        exit(1);
+    }
+
+    if (m_boltzmann_policy) {
+        delete m_boltzmann_policy;
+        m_boltzmann_policy = nullptr;
+    }
+
+    if (policy_type == PolicyType::BOLTZMANN) {
+        m_boltzmann_policy = new BoltzmannPolicy(boltzmann_parameters.initial_temp, boltzmann_parameters.decay_rate, boltzmann_parameters.min_temp, boltzmann_parameters.decay_interval);
+    } else {
+        std::cerr << "VecEnv only supports the Boltzmann policy" << std::endl;
+        exit(1);
+    }
+}
+
+void VecEnv::setRNDEnabled(bool enabled) {
+    for (auto& env : m_envs) {
+        env.setRNDEnabled(enabled);
+    }
+}
+
+void VecEnv::reset() {
+    for (auto& env : m_envs) {
+        env.reset();
+    }
+}
+
+const std::vector<int>& VecEnv::step() {
+    const int num_envs = size();
+    const int input_dim = dqn_parameters.DQN_INPUT_DIM;
+    const int output_dim = dqn_parameters.DQN_OUTPUT_DIM;
+
+    m_inputs.resize(num_envs * input_dim);
+    m_q_values.resize(num_envs * output_dim);
+
+    // 1. Encode every env's current state into one input batch
+    for (int i = 0; i < num_envs; ++i) {
+        prepareInputData(m_agents[i].getState(), m_inputs.data() + i * input_dim);
+    }
+
+    // 2. One forward pass for all envs
+    nn_predict(m_trainer->actorNetworks().dqn_online, m_inputs.data(), m_q_values.data(), num_envs);
+
+    // 3. Act in every env, resetting the ones that finished
+    m_finished.clear();
+    for (int i = 0; i < num_envs; ++i) {
+        Action action = m_boltzmann_policy->chooseAction(m_q_values.data() + i * output_dim);
+
+        if (!m_envs[i].step(action)) {
+            m_episode_lengths[i] = m_envs[i].getTimestep();
+            m_envs[i].reset();
+            m_finished.push_back(i);
+        }
+    }
+
+    return m_finished;
+}
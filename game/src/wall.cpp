@@ -8,9 +8,11 @@ bool Wall::move(int dx, int dy) {
     // Wall does not move
 }
 
+#ifndef HEADLESS
 void Wall::draw(SDL_Renderer* renderer) {
     // Draw wall as a filled rectangle
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Black color
     SDL_Rect rect = {x - WALL_WIDTH / 2, y - WALL_HEIGHT / 2, WALL_WIDTH, WALL_HEIGHT};
     SDL_RenderFillRect(renderer, &rect);
-}
\ No newline at end of file
+}
+#endif
@@ -3,32 +3,50 @@
 #ifndef ACTIVATION_H
 #define ACTIVATION_H
 
-class Activation_ReLU {
+template <typename eT>
+class Activation_ReLUT {
     public:
-        arma::mat m_output;
-        arma::mat m_inputs;
+        using mat_type = arma::Mat<eT>;
+
+        mat_type m_output;
+        mat_type m_inputs;
 
         // constructor for 
 
-        void forward(const arma::mat inputs);
+        void forward(const mat_type inputs);
 
-        arma::mat backward(const arma::mat& dvalues);
+        mat_type backward(const mat_type& dvalues);
 
         void reset();
 };
 
-class Activation_ReLU_Leaky {
+template <typename eT>
+class Activation_ReLU_LeakyT {
     public:
-        arma::mat m_output;
-        arma::mat m_inputs;
+        using mat_type = arma::Mat<eT>;
+
+        mat_type m_output;
+        mat_type m_inputs;
 
         double m_alpha = 0.01; // Leaky ReLU parameter
 
-        void forward(const arma::mat inputs);
+        void forward(const mat_type inputs);
+
+        // Inference-only, applied in place without caching the inputs
+        void forward_inplace(mat_type& values) const;
 
-        arma::mat backward(const arma::mat& dvalues);
+        mat_type backward(const mat_type& dvalues);
 
         void reset();
 };
 
-#endif
\ No newline at end of file
+// instantiated for double and float in activation.cpp
+extern template class Activation_ReLUT<double>;
+extern template class Activation_ReLUT<float>;
+extern template class Activation_ReLU_LeakyT<double>;
+extern template class Activation_ReLU_LeakyT<float>;
+
+using Activation_ReLU = Activation_ReLUT<double>;
+using Activation_ReLU_Leaky = Activation_ReLU_LeakyT<double>;
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef CHECKPOINT_WRITER_H
+#define CHECKPOINT_WRITER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdint>
+
+// Background checkpoint writer. The training thread packs a model into memory (pack_model)
+// and submits the buffer; a single writer thread checksums, writes and fsyncs it, in
+// submission order. If a directory is submitted again before its previous save started, the
+// older buffer is dropped and only the newest one is written.
+//
+// Every submit returns a ticket; status() reports it as pending, done or failed. Pending
+// saves are finished before the process exits.
+class CheckpointWriter {
+    public:
+        enum Status : int32_t {
+            FAILED = -1,
+            PENDING = 0,
+            DONE = 1,
+            UNKNOWN = 2, // ticket never issued or already collected
+        };
+
+        static CheckpointWriter& getInstance();
+
+        uint64_t submit(const std::string& dirname, std::vector<char>&& buffer);
+
+        // Status of ticket; DONE/FAILED are reported once, then the ticket is forgotten
+        int32_t status(uint64_t ticket);
+
+        // Block until every submitted save has finished, returns the failures since the last call
+        uint32_t wait();
+
+    private:
+        struct Job {
+            uint64_t ticket;
+            std::string dirname;
+            std::vector<char> buffer;
+        };
+
+        CheckpointWriter();
+        ~CheckpointWriter();
+
+        CheckpointWriter(const CheckpointWriter&) = delete;
+        CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+        void run();
+
+        std::mutex m_mutex;
+        std::condition_variable m_work_cv;
+        std::condition_variable m_idle_cv;
+        std::deque<Job> m_queue;
+        std::unordered_map<uint64_t, int32_t> m_status;
+        uint64_t m_next_ticket = 1;
+        uint32_t m_failures = 0;
+        bool m_busy = false;
+        bool m_stop = false;
+
+        std::thread m_thread;
+};
+
+#endif
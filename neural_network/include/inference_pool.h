@@ -0,0 +1,52 @@
+#ifndef INFERENCE_POOL_H
+#define INFERENCE_POOL_H
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstddef>
+
+// Worker threads for independent forward passes (predict_many). run() hands the tasks to the
+// workers, executes some itself and returns once all of them have finished, so the caller's
+// buffers never outlive a task. Several threads may call run() at the same time.
+class InferencePool {
+    public:
+        static InferencePool& getInstance();
+
+        void run(std::vector<std::function<void()>>& tasks);
+
+        size_t workers() const { return m_threads.size(); }
+
+    private:
+        // one run() call: tasks still to start and the ones not yet finished
+        struct Batch {
+            std::vector<std::function<void()>>* tasks;
+            size_t next = 0;
+            size_t remaining = 0;
+            std::condition_variable done_cv;
+        };
+
+        InferencePool();
+        ~InferencePool();
+
+        InferencePool(const InferencePool&) = delete;
+        InferencePool& operator=(const InferencePool&) = delete;
+
+        void workerLoop();
+
+        // Runs the next task of the oldest batch with tasks left, lock held on entry and exit.
+        // False if there is nothing to start
+        bool runOne(std::unique_lock<std::mutex>& lock);
+
+        std::mutex m_mutex;
+        std::condition_variable m_work_cv;
+        std::deque<Batch*> m_batches;
+        bool m_stop = false;
+
+        std::vector<std::thread> m_threads;
+};
+
+#endif
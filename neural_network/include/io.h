@@ -10,14 +10,88 @@ struct NNInfo_metadata {
     uint32_t num_m_layers;
     uint32_t batch_size;
     uint32_t nn_type;
+    uint32_t precision; // bytes per stored element, 8 (double) or 4 (float)
+    double optimizer_step = 0.0; // Adam step at save time, 0 for models saved without optimizer state
 };
 
+// Models written before precision was recorded have no precision field and are double
+#define NN_LEGACY_INFO_SIZE (6 * sizeof(uint32_t))
+
+// Single-file checkpoint, <model dir>/model.ckpt:
+//   NNCheckpointHeader (64 bytes)
+//   tensor_count x NNTensorEntry (32 bytes each) at directory_offset
+//   tensor data, column-major like arma, every tensor starting on a 64 byte boundary
+// checksum is a 64-bit FNV-1a over the words of everything after the header. The file is
+// written to model.ckpt.tmp and renamed over the old one, so a crash mid-save never leaves a
+// torn checkpoint. Directories holding only the old per-tensor files (nn_info.bin,
+// layerN_*.bin) still load.
+//
+// Version 2 adds the optimizer state, so training resumes where it stopped: the Adam moments
+// of every layer that has been trained, and the optimizer step as a single double (also the
+// LR scheduler position). Version 1 files load with fresh moments.
+#define NN_CHECKPOINT_FILE "model.ckpt"
+#define NN_CHECKPOINT_VERSION 2
+#define NN_CHECKPOINT_ALIGN 64
+
+enum NNTensorKind : uint32_t {
+    NN_TENSOR_WEIGHTS = 0,
+    NN_TENSOR_BIASES = 1,
+    NN_TENSOR_VELOCITY_WEIGHTS = 2,
+    NN_TENSOR_VELOCITY_BIASES = 3,
+    NN_TENSOR_ADAM_WEIGHT_MOMENTUMS = 4,
+    NN_TENSOR_ADAM_WEIGHT_CACHE = 5,
+    NN_TENSOR_ADAM_BIAS_MOMENTUMS = 6,
+    NN_TENSOR_ADAM_BIAS_CACHE = 7,
+    NN_TENSOR_OPTIMIZER_STEP = 8, // 1x1, always stored as a double whatever the precision
+};
+
+struct NNCheckpointHeader {
+    char magic[8];             // "NNCKPT"
+    uint32_t version;
+    uint32_t header_size;      // sizeof(NNCheckpointHeader)
+    uint32_t input_dim;
+    uint32_t output_dim;
+    uint32_t hidden_dim;
+    uint32_t num_m_layers;
+    uint32_t batch_size;
+    uint32_t nn_type;
+    uint32_t precision;        // bytes per element
+    uint32_t tensor_count;
+    uint64_t directory_offset;
+    uint64_t checksum;
+};
+
+struct NNTensorEntry {
+    uint32_t layer;
+    uint32_t kind;             // NNTensorKind
+    uint32_t rows;
+    uint32_t cols;
+    uint64_t offset;           // from the start of the file, NN_CHECKPOINT_ALIGN aligned
+    uint64_t bytes;
+};
+
+static_assert(sizeof(NNCheckpointHeader) == 64, "checkpoint header layout is part of the file format");
+static_assert(sizeof(NNTensorEntry) == 32, "checkpoint directory layout is part of the file format");
+
+// write_model/read_model are instantiated for double and float layers in io.cpp. read_model
+// converts the stored precision to eT, so a double model can be loaded as float and back
+template <typename eT>
 bool write_model(const std::string& dirname,
-    const std::vector<LayerDense>& layers, uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim, 
-    uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type);
+    const std::vector<LayerDenseT<eT>>& layers, uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim, 
+    uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type, double optimizer_step);
 
+// write_model in two halves: pack_model serializes the layers into an in-memory checkpoint
+// (a plain copy, safe to hand to another thread), write_packed_model fills in the checksum
+// and writes it to <dirname>/model.ckpt atomically. Both throw on failure
+template <typename eT>
+std::vector<char> pack_model(const std::vector<LayerDenseT<eT>>& layers, uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim,
+    uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type, double optimizer_step);
+
+bool write_packed_model(const std::string& dirname, std::vector<char>& buffer);
+
+template <typename eT>
 bool read_model(const std::string& dirname,
-    std::vector<LayerDense>& layers, NNInfo_metadata& nn_info);
+    std::vector<LayerDenseT<eT>>& layers, NNInfo_metadata& nn_info);
 
 struct RND_Params {
     double LR_INITIAL;
@@ -37,9 +111,17 @@ struct DQN_Params {
     double min_learning_rate;
 };
 
+struct Telemetry_Params {
+    int LOSS_LOG_INTERVAL = 1;   // log every k-th training step / aggregate windows of k steps
+    int LOSS_LOG_MODE = 0;       // 0 = sample one step per interval, 1 = mean/min/max per window
+    int LOSS_FLUSH_LINES = 1024; // lines kept in memory between writes
+};
+
 bool parse_rnd_params(const std::string& param_file_path, RND_Params& rnd_params); // parse RND hyperparam file, return success or not
 
 bool parse_dqn_params(const std::string& param_file_path, DQN_Params& dqn_params); // parse DQN hyperparam file, return success or not
 
+bool parse_telemetry_params(const std::string& param_file_path, Telemetry_Params& telemetry_params); // parse loss logging params, defaults if the block is missing
+
 
 #endif
\ No newline at end of file
@@ -6,29 +6,35 @@
 #include <iostream> // For std::cout (for testing)
 #include <armadillo> // For arma::mat, arma::vec etc.
 
-class LayerDense {
+// eT is the element type, double or float (see the LayerDense/LayerDenseF aliases below)
+template <typename eT>
+class LayerDenseT {
     private:
         uint32_t n_inputs;
         uint32_t n_neurons;
 
     public:
-        arma::mat m_output;
-        arma::mat m_inputs; // Stores a_k^{l-1} (activations from previous layer)
+        using elem_type = eT;
+        using mat_type = arma::Mat<eT>;
+        using rowvec_type = arma::Row<eT>;
 
-        arma::mat m_dweights, m_dbiases, m_dinputs; // Gradients stored here
+        mat_type m_output;
+        mat_type m_inputs; // Stores a_k^{l-1} (activations from previous layer)
 
-        arma::mat m_weights;
-        arma::mat m_biases;
+        mat_type m_dweights, m_dbiases, m_dinputs; // Gradients stored here
+
+        mat_type m_weights;
+        mat_type m_biases;
 
         // set velocity
-        arma::mat m_velocity_weights;
-        arma::mat m_velocity_biases;
+        mat_type m_velocity_weights;
+        mat_type m_velocity_biases;
 
         // For adam optimizer
-        arma::mat m_weight_momentums;  // first moment (⎯v)
-        arma::mat m_weight_cache;      // second moment (⎯s)
-        arma::rowvec m_bias_momentums;
-        arma::rowvec m_bias_cache;
+        mat_type m_weight_momentums;  // first moment (⎯v)
+        mat_type m_weight_cache;      // second moment (⎯s)
+        rowvec_type m_bias_momentums;
+        rowvec_type m_bias_cache;
 
 
         int gradient_counter = 0;
@@ -37,36 +43,52 @@ class LayerDense {
         double m_weight_regularizer_L1, m_weight_regularizer_L2;
         double m_bias_regularizer_L1, m_bias_regularizer_L2;
 
-        LayerDense(uint32_t n_inputs, uint32_t n_neurons, double weight_regularizer_L1 = 0.0, double weight_regularizer_L2 = 0.0, 
+        LayerDenseT(uint32_t n_inputs, uint32_t n_neurons, double weight_regularizer_L1 = 0.0, double weight_regularizer_L2 = 0.0, 
             double bias_regularizer_L1 = 0.0, double bias_regularizer_L2 = 0.0);
 
         // Copy constructor
         //LayerDense(const LayerDense&) = default;
 
-        LayerDense(const LayerDense& other);
+        LayerDenseT(const LayerDenseT& other);
 
 
         void reset();
 
-        void set_weights(arma::mat weights);
+        void set_weights(mat_type weights);
+
+        void set_biases(mat_type biases);
+
+        void forward(mat_type inputs);
 
-        void set_biases(arma::mat biases);
+        void backward(mat_type dvalues);
 
-        void forward(arma::mat inputs);
+        // Inference-only forward pass: nothing is cached for backward. Works feature-major
+        // (one column per sample), outputs_t must already be n_neurons x batch
+        void forward_inference(const mat_type& inputs_t, mat_type& outputs_t) const;
 
-        void backward(arma::mat dvalues);
+        // Target network sync, in place: weights/biases <- tau * source + (1 - tau) * own.
+        // tau = 1 is a plain copy. Shapes must match, nothing is allocated and only the
+        // parameter tensors are touched
+        void blend_parameters(const LayerDenseT& source, double tau);
 
-        void set_dweights(arma::mat dweights) { m_dweights = dweights; }
+        void set_dweights(mat_type dweights) { m_dweights = dweights; }
 
-        void set_dbiases(arma::mat dbiases) { m_dbiases = dbiases; }
+        void set_dbiases(mat_type dbiases) { m_dbiases = dbiases; }
 
-        void set_dinputs(arma::mat dinputs) { m_dinputs = dinputs; }
+        void set_dinputs(mat_type dinputs) { m_dinputs = dinputs; }
 
-        arma::mat get_dweights() const { return m_dweights; }
+        mat_type get_dweights() const { return m_dweights; }
 
-        arma::mat get_dbiases() const { return m_dbiases; }
+        mat_type get_dbiases() const { return m_dbiases; }
 
-        arma::mat get_dinputs() const { return m_dinputs; }
+        mat_type get_dinputs() const { return m_dinputs; }
 };
 
-#endif // LAYER_DENSE_H
\ No newline at end of file
+// instantiated for double and float in layer_dense.cpp
+extern template class LayerDenseT<double>;
+extern template class LayerDenseT<float>;
+
+using LayerDense = LayerDenseT<double>;
+using LayerDenseF = LayerDenseT<float>;
+
+#endif // LAYER_DENSE_H
@@ -0,0 +1,84 @@
+#ifndef LOSS_TELEMETRY_H
+#define LOSS_TELEMETRY_H
+
+#include <fstream>
+#include <string>
+#include <cstdint>
+#include <io.h>
+
+// Training-loss log of one network. Lines are collected in memory and written in blocks of
+// LOSS_FLUSH_LINES, so training never waits on a flush. Every line starts with the training
+// step it describes:
+//   mode 0 (sample): "<step> <loss>" every LOSS_LOG_INTERVAL-th step
+//   mode 1 (window): "<step> <mean> <min> <max>" over each window of LOSS_LOG_INTERVAL steps,
+//                    of the data loss plus the regularization term evaluated at the window end
+class LossTelemetry {
+    private:
+        std::ofstream m_file;
+        std::string m_buffer;
+        uint32_t m_buffered_lines = 0;
+
+        Telemetry_Params m_params;
+        uint64_t m_step = 0;
+
+        // window mode accumulators
+        double m_sum = 0.0;
+        double m_min = 0.0;
+        double m_max = 0.0;
+        uint32_t m_count = 0;
+
+        bool closesRecord() const;
+        void appendLine(const char* line, int length);
+
+    public:
+        LossTelemetry() = default;
+        ~LossTelemetry();
+
+        LossTelemetry(const LossTelemetry&) = delete;
+        LossTelemetry& operator=(const LossTelemetry&) = delete;
+
+        // Truncates path unless append, returns false if it can't be opened
+        bool open(const std::string& path, const Telemetry_Params& params, bool append);
+
+        bool isOpen() const { return m_file.is_open(); }
+
+        // Whether the current training step has to compute its data loss at all
+        bool wantsLoss() const { return isOpen() && (m_params.LOSS_LOG_MODE == 1 || closesRecord()); }
+
+        // Whether the current step emits a line, the only steps that pay for the regularization term
+        bool wantsRegularization() const { return isOpen() && closesRecord(); }
+
+        // Loss of the current step; reg_loss is only read when wantsRegularization()
+        void record(double data_loss, double reg_loss);
+
+        // Called once at the end of every training step
+        void advance() { m_step++; }
+
+        // Continue the step count of a loaded network, so its lines follow the earlier ones
+        void resumeAt(uint64_t step) { m_step = step; }
+
+        void flush();
+};
+
+// One network's hold on a loss log file. Two live networks never write the same file: claim()
+// takes base_path, or <stem>_2<ext>, <stem>_3<ext>, ... while another network holds it. The
+// first claim of a path in a process truncates it, later ones (a network reloaded or rebuilt
+// in the same run) append, so a run keeps its whole history. Released on destruction
+class LossLogClaim {
+    private:
+        std::string m_path;
+
+    public:
+        LossLogClaim() = default;
+        ~LossLogClaim();
+
+        LossLogClaim(const LossLogClaim&) = delete;
+        LossLogClaim& operator=(const LossLogClaim&) = delete;
+
+        // Returns whether the file has to be opened in append mode
+        bool claim(const std::string& base_path);
+
+        const std::string& path() const { return m_path; }
+};
+
+#endif
@@ -4,14 +4,22 @@
 #include <armadillo>
 #include <layer_dense.h>
 
-double mse_loss(const arma::mat& acc, const arma::mat& pred);
+// All losses are templated on the element type and instantiated for double and float in
+// loss_utils.cpp. Loss values are always accumulated and returned as double.
 
-arma::mat derivative_mse_loss(const arma::mat& acc, const arma::mat& pred);
+template <typename eT>
+double mse_loss(const arma::Mat<eT>& acc, const arma::Mat<eT>& pred);
 
-double regularization_loss(const LayerDense& layer);
+template <typename eT>
+arma::Mat<eT> derivative_mse_loss(const arma::Mat<eT>& acc, const arma::Mat<eT>& pred);
 
-double huber_loss(const arma::mat& predictions, const arma::mat& targets, double delta);
+template <typename eT>
+double regularization_loss(const LayerDenseT<eT>& layer);
 
-arma::mat derivative_huber_loss(const arma::mat& predictions, const arma::mat& targets, double delta);
+template <typename eT>
+double huber_loss(const arma::Mat<eT>& predictions, const arma::Mat<eT>& targets, double delta);
 
-#endif
\ No newline at end of file
+template <typename eT>
+arma::Mat<eT> derivative_huber_loss(const arma::Mat<eT>& predictions, const arma::Mat<eT>& targets, double delta);
+
+#endif
@@ -33,6 +33,10 @@ public:
     double m_beta2;
     double m_eps;
 
+    // 1 / (1 - beta^step), set once per step in pre_update_params
+    double m_momentum_correction = 1.0;
+    double m_cache_correction = 1.0;
+
     Optimizer_Adam(double learning_rate = 0.001,
                    double beta1 = 0.9,
                    double beta2 = 0.999,
@@ -42,7 +46,11 @@ public:
                    double min_lr = 1e-5);
 
     void pre_update_params();
-    void update(LayerDense &layer);
+
+    // instantiated for LayerDense and LayerDenseF in optimizer.cpp
+    template <typename eT>
+    void update(LayerDenseT<eT> &layer);
+
     void post_update_params();
 };
 
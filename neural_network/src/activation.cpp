@@ -1,43 +1,63 @@
 #include <activation.h>
 
-void Activation_ReLU::forward(const arma::mat inputs) {
+template <typename eT>
+void Activation_ReLUT<eT>::forward(const mat_type inputs) {
     m_output = inputs;
     m_inputs = inputs;
     
     for (size_t i = 0; i < m_output.n_rows; ++i) {
         for (size_t j = 0; j < m_output.n_cols; ++j) {
-            m_output(i, j) = std::max(0.0, m_output(i, j));
+            m_output(i, j) = std::max(eT(0), m_output(i, j));
         }
     }
 }
 
-arma::mat Activation_ReLU::backward(const arma::mat& dvalues) {
-    // Convert boolean mask to double values (1.0/0.0)
-    arma::mat drelu = arma::conv_to<arma::mat>::from(m_inputs > 0.0);
+template <typename eT>
+typename Activation_ReLUT<eT>::mat_type Activation_ReLUT<eT>::backward(const mat_type& dvalues) {
+    // Convert boolean mask to eT values (1.0/0.0)
+    mat_type drelu = arma::conv_to<mat_type>::from(m_inputs > eT(0));
     return dvalues % drelu;  // Element-wise multiplication
 }
 
-void Activation_ReLU::reset() {
+template <typename eT>
+void Activation_ReLUT<eT>::reset() {
     m_inputs.clear();
     m_output.clear();
 }
 
-void Activation_ReLU_Leaky::forward(const arma::mat inputs) {
+template <typename eT>
+void Activation_ReLU_LeakyT<eT>::forward(const mat_type inputs) {
     m_inputs = inputs;
     m_output = inputs;
 
-    m_output.transform([this](double val) { 
-        return val > 0 ? val : m_alpha * val;
+    const eT alpha = static_cast<eT>(m_alpha);
+    m_output.transform([alpha](eT val) { 
+        return val > 0 ? val : alpha * val;
     });
 }
 
-arma::mat Activation_ReLU_Leaky::backward(const arma::mat& dvalues) {
-    arma::mat drelu = arma::mat(m_inputs.n_rows, m_inputs.n_cols, arma::fill::ones);
-    drelu.elem(arma::find(m_inputs <= 0)).fill(m_alpha);  // Vectorized operation
+template <typename eT>
+void Activation_ReLU_LeakyT<eT>::forward_inplace(mat_type& values) const {
+    const eT alpha = static_cast<eT>(m_alpha);
+    values.transform([alpha](eT val) {
+        return val > 0 ? val : alpha * val;
+    });
+}
+
+template <typename eT>
+typename Activation_ReLU_LeakyT<eT>::mat_type Activation_ReLU_LeakyT<eT>::backward(const mat_type& dvalues) {
+    mat_type drelu = mat_type(m_inputs.n_rows, m_inputs.n_cols, arma::fill::ones);
+    drelu.elem(arma::find(m_inputs <= eT(0))).fill(static_cast<eT>(m_alpha));  // Vectorized operation
     return dvalues % drelu;  // Element-wise multiplication
 }
 
-void Activation_ReLU_Leaky::reset() {
+template <typename eT>
+void Activation_ReLU_LeakyT<eT>::reset() {
     m_inputs.reset();
     m_output.reset();
-}
\ No newline at end of file
+}
+
+template class Activation_ReLUT<double>;
+template class Activation_ReLUT<float>;
+template class Activation_ReLU_LeakyT<double>;
+template class Activation_ReLU_LeakyT<float>;
@@ -0,0 +1,106 @@
+#include <checkpoint_writer.h>
+#include <io.h>
+#include <iostream>
+#include <chrono>
+
+CheckpointWriter& CheckpointWriter::getInstance() {
+    static CheckpointWriter instance;
+    return instance;
+}
+
+CheckpointWriter::CheckpointWriter() {
+    m_thread = std::thread(&CheckpointWriter::run, this);
+}
+
+CheckpointWriter::~CheckpointWriter() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+uint64_t CheckpointWriter::submit(const std::string& dirname, std::vector<char>&& buffer) {
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ticket = m_next_ticket++;
+
+        // a newer snapshot supersedes one that is still waiting for the same directory
+        for (auto& job : m_queue) {
+            if (job.dirname == dirname) {
+                m_status[job.ticket] = DONE;
+                job.ticket = ticket;
+                job.buffer = std::move(buffer);
+                m_status[ticket] = PENDING;
+                return ticket;
+            }
+        }
+
+        m_queue.push_back(Job{ticket, dirname, std::move(buffer)});
+        m_status[ticket] = PENDING;
+    }
+    m_work_cv.notify_one();
+    return ticket;
+}
+
+int32_t CheckpointWriter::status(uint64_t ticket) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_status.find(ticket);
+    if (it == m_status.end()) {
+        return UNKNOWN;
+    }
+    int32_t result = it->second;
+    if (result != PENDING) {
+        m_status.erase(it);
+    }
+    return result;
+}
+
+uint32_t CheckpointWriter::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle_cv.wait(lock, [this] { return m_queue.empty() && !m_busy; });
+    uint32_t failures = m_failures;
+    m_failures = 0;
+    return failures;
+}
+
+void CheckpointWriter::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_work_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+        if (m_queue.empty()) {
+            return; // stopping, everything submitted has been written
+        }
+
+        Job job = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_busy = true;
+        lock.unlock();
+
+        bool ok = false;
+        auto start = std::chrono::steady_clock::now();
+        try {
+            ok = write_packed_model(job.dirname, job.buffer);
+        } catch (const std::exception& e) {
+            std::cerr << "Checkpoint Error: " << job.dirname << ": " << e.what() << std::endl;
+        }
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed > 1000.0) {
+            std::cerr << "Slow checkpoint: " << job.dirname << " took " << elapsed << " ms" << std::endl;
+        }
+
+        lock.lock();
+        m_busy = false;
+        m_status[job.ticket] = ok ? DONE : FAILED;
+        if (!ok) {
+            m_failures++;
+        }
+        if (m_queue.empty()) {
+            m_idle_cv.notify_all();
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#include <inference_pool.h>
+#include <algorithm>
+
+InferencePool& InferencePool::getInstance() {
+    static InferencePool instance;
+    return instance;
+}
+
+InferencePool::InferencePool() {
+    // the caller runs tasks too; a few workers cover the handful of networks one step evaluates
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    unsigned int count = std::min(3u, cores - 1);
+    for (unsigned int i = 0; i < count; ++i) {
+        m_threads.emplace_back(&InferencePool::workerLoop, this);
+    }
+}
+
+InferencePool::~InferencePool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_cv.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void InferencePool::run(std::vector<std::function<void()>>& tasks) {
+    if (tasks.empty()) {
+        return;
+    }
+    if (tasks.size() == 1 || m_threads.empty()) {
+        for (auto& task : tasks) {
+            task();
+        }
+        return;
+    }
+
+    Batch batch;
+    batch.tasks = &tasks;
+    batch.remaining = tasks.size();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_batches.push_back(&batch);
+    m_work_cv.notify_all();
+
+    // help out until every task has started, then wait for the workers' last ones. The batch
+    // lives on this stack frame, so return only once nobody touches it anymore
+    while (batch.next < tasks.size()) {
+        runOne(lock);
+    }
+    batch.done_cv.wait(lock, [&batch] { return batch.remaining == 0; });
+}
+
+bool InferencePool::runOne(std::unique_lock<std::mutex>& lock) {
+    if (m_batches.empty()) {
+        return false;
+    }
+
+    Batch* batch = m_batches.front();
+    std::function<void()>& task = (*batch->tasks)[batch->next++];
+    if (batch->next == batch->tasks->size()) {
+        m_batches.pop_front(); // all started, finishing is tracked by remaining
+    }
+
+    lock.unlock();
+    task();
+    lock.lock();
+
+    if (--batch->remaining == 0) {
+        batch->done_cv.notify_all();
+    }
+    return true;
+}
+
+void InferencePool::workerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_work_cv.wait(lock, [this] { return m_stop || !m_batches.empty(); });
+        if (m_stop) {
+            return;
+        }
+        runOne(lock);
+    }
+}
@@ -5,87 +5,20 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <cerrno>
+#include <filesystem>
 #include <armadillo>
 
-bool write_model(const std::string& dirname, const std::vector<LayerDense>& layers, uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim, 
-    uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type) {
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
-    if (layers.empty()) {
-        throw std::runtime_error("No layers to write");
-        return false;
-    }
-
-    std::filesystem::create_directories(dirname);
-
-    std::error_code dir_error;
-    std::filesystem::create_directories(dirname, dir_error);
-    if (dir_error) {
-        throw std::runtime_error("Failed to create directory: " + dirname + " - " + dir_error.message());
-    }
-    if (!std::filesystem::is_directory(dirname)) {
-        throw std::runtime_error("Path is not a directory: " + dirname);
-    }
-
-    // write NN auxilary info to file
-
-    // init out
-    std::ofstream out;
-
-    out.open(dirname + "/nn_info.bin", std::ios::binary);
-    if (!out) {
-        throw std::runtime_error("Cannot open file: " + dirname + "/nn_info.bin");
-    }
-
-    // Write num layers, batch size and NN type
-
-
-    // Write input,output and hidden dims
-    // Write num layers, batch size and NN type
-    out.write(reinterpret_cast<const char*>(&input_dim), sizeof(input_dim));
-    out.write(reinterpret_cast<const char*>(&output_dim), sizeof(output_dim));
-    out.write(reinterpret_cast<const char*>(&hidden_dim), sizeof(hidden_dim));
-    out.write(reinterpret_cast<const char*>(&num_m_layers), sizeof(num_m_layers));
-    out.write(reinterpret_cast<const char*>(&batch_size), sizeof(batch_size));
-    out.write(reinterpret_cast<const char*>(&nn_type), sizeof(nn_type));
-
-    for (size_t i = 0; i < layers.size(); ++i) {
-        std::ofstream out;
-        const LayerDense& layer = layers[i];
-
-        // Helper function to write layer data
-        auto write_layer_data = [&](const std::string& filename, 
-                                  const auto& matrix) {
-            out.open(filename, std::ios::binary);
-            if (!out) {
-                throw std::runtime_error("Cannot open file: " + filename);
-            }
-
-            // Write matrix dimensions (rows, cols) instead of num_layers
-            uint32_t rows = static_cast<uint32_t>(matrix.n_rows);
-            uint32_t cols = static_cast<uint32_t>(matrix.n_cols);
-            out.write(reinterpret_cast<const char*>(&rows), sizeof(rows));
-            out.write(reinterpret_cast<const char*>(&cols), sizeof(cols));
-
-            // Write matrix data
-            out.write(reinterpret_cast<const char*>(matrix.memptr()),
-                     matrix.n_elem * sizeof(typename std::decay_t<decltype(matrix)>::elem_type));
-            
-            out.close();
-        };
-
-        // Generate filenames
-        std::string prefix = dirname + "/layer" + std::to_string(i);
-        
-        // Write weights and biases
-        write_layer_data(prefix + "_weights.bin", layer.m_weights);
-        write_layer_data(prefix + "_biases.bin", layer.m_biases);
-        write_layer_data(prefix + "_velocity_weights.bin", layer.m_velocity_weights);
-        write_layer_data(prefix + "_velocity_biases.bin", layer.m_velocity_biases);
-    }
-    return true;
-}
-
-bool read_model(const std::string& dirname, std::vector<LayerDense>& layers, NNInfo_metadata& nn_info) {
+// Old layout: nn_info.bin plus four files per layer
+template <typename eT>
+static bool read_model_legacy(const std::string& dirname, std::vector<LayerDenseT<eT>>& layers, NNInfo_metadata& nn_info) {
     namespace fs = std::filesystem;
     
     try {
@@ -101,7 +34,19 @@ bool read_model(const std::string& dirname, std::vector<LayerDense>& layers, NNI
 
         // 2. Read metadata
         std::ifstream meta_in(fs::path(dirname) / "nn_info.bin", std::ios::binary);
-        meta_in.read(reinterpret_cast<char*>(&nn_info), sizeof(NNInfo_metadata));
+        meta_in.read(reinterpret_cast<char*>(&nn_info), NN_LEGACY_INFO_SIZE);
+        if (!meta_in) {
+            throw std::runtime_error("Metadata file is truncated in directory: " + dirname);
+        }
+
+        // precision was added after the first models were saved, those are all double
+        if (!meta_in.read(reinterpret_cast<char*>(&nn_info.precision), sizeof(nn_info.precision))) {
+            nn_info.precision = sizeof(double);
+        }
+        nn_info.optimizer_step = 0.0; // no optimizer state in the old layout
+        if (nn_info.precision != sizeof(double) && nn_info.precision != sizeof(float)) {
+            throw std::runtime_error("Unsupported model precision: " + std::to_string(nn_info.precision) + " bytes");
+        }
         
         // 3. Prepare layers vector
         layers.clear();
@@ -117,8 +62,9 @@ bool read_model(const std::string& dirname, std::vector<LayerDense>& layers, NNI
 
         // 5. Load layer parameters
         // 5. Load layer parameters
-        auto load_layer = [](LayerDense& layer, const std::string& prefix) {
-            auto read_matrix = [](const std::string& path) -> arma::mat {
+        const uint32_t precision = nn_info.precision;
+        auto load_layer = [precision](LayerDenseT<eT>& layer, const std::string& prefix) {
+            auto read_matrix = [precision](const std::string& path) -> arma::Mat<eT> {
                 std::ifstream in(path, std::ios::binary);
                 if (!in) {
                     throw std::runtime_error("Cannot open file: " + path);
@@ -129,12 +75,19 @@ bool read_model(const std::string& dirname, std::vector<LayerDense>& layers, NNI
                 in.read(reinterpret_cast<char*>(&rows), sizeof(rows));
                 in.read(reinterpret_cast<char*>(&cols), sizeof(cols));
 
-                // Create and fill matrix
-                arma::mat matrix(rows, cols);
-                in.read(reinterpret_cast<char*>(matrix.memptr()), 
-                        rows * cols * sizeof(arma::mat::elem_type));
-                
-                return matrix;
+                // Read in the stored precision, converting if the network uses the other one
+                auto read_as = [&](auto stored) -> arma::Mat<eT> {
+                    using stored_type = decltype(stored);
+                    arma::Mat<stored_type> matrix(rows, cols);
+                    in.read(reinterpret_cast<char*>(matrix.memptr()),
+                            rows * cols * sizeof(stored_type));
+                    return arma::conv_to<arma::Mat<eT>>::from(matrix);
+                };
+
+                if (precision == sizeof(float)) {
+                    return read_as(float{});
+                }
+                return read_as(double{});
             };
 
             layer.m_weights = read_matrix(prefix + "_weights.bin");
@@ -156,6 +109,324 @@ bool read_model(const std::string& dirname, std::vector<LayerDense>& layers, NNI
     }
 }
 
+namespace {
+
+    size_t align_up(size_t n) {
+        return (n + NN_CHECKPOINT_ALIGN - 1) & ~static_cast<size_t>(NN_CHECKPOINT_ALIGN - 1);
+    }
+
+    // 64-bit FNV-1a, fed a word at a time
+    uint64_t checkpoint_checksum(const unsigned char* data, size_t size) {
+        uint64_t hash = 14695981039346656037ULL;
+        const size_t words = size / sizeof(uint64_t);
+        for (size_t i = 0; i < words; ++i) {
+            uint64_t word;
+            std::memcpy(&word, data + i * sizeof(uint64_t), sizeof(word));
+            hash = (hash ^ word) * 1099511628211ULL;
+        }
+        for (size_t i = words * sizeof(uint64_t); i < size; ++i) {
+            hash = (hash ^ data[i]) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    // One write of the whole buffer to <path>.tmp, fsync, then rename over path
+    void write_file_atomic(const std::string& path, const char* data, size_t size) {
+        const std::string tmp_path = path + ".tmp";
+        int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open file: " + tmp_path + " - " + std::strerror(errno));
+        }
+
+        size_t written = 0;
+        while (written < size) {
+            ssize_t n = ::write(fd, data + written, size - written);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                std::string reason = std::strerror(errno);
+                ::close(fd);
+                ::unlink(tmp_path.c_str());
+                throw std::runtime_error("Cannot write file: " + tmp_path + " - " + reason);
+            }
+            written += static_cast<size_t>(n);
+        }
+
+        if (::fsync(fd) != 0 || ::close(fd) != 0) {
+            ::unlink(tmp_path.c_str());
+            throw std::runtime_error("Cannot sync file: " + tmp_path);
+        }
+
+        std::filesystem::rename(tmp_path, path);
+    }
+
+    // Read-only mapping of a whole file, unmapped on destruction
+    class MappedFile {
+        public:
+            explicit MappedFile(const std::string& path) {
+                m_fd = ::open(path.c_str(), O_RDONLY);
+                if (m_fd < 0) {
+                    throw std::runtime_error("Cannot open file: " + path);
+                }
+                struct stat st;
+                if (::fstat(m_fd, &st) != 0) {
+                    ::close(m_fd);
+                    throw std::runtime_error("Cannot stat file: " + path);
+                }
+                m_size = static_cast<size_t>(st.st_size);
+                if (m_size > 0) {
+                    void* addr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+                    if (addr == MAP_FAILED) {
+                        ::close(m_fd);
+                        throw std::runtime_error("Cannot map file: " + path);
+                    }
+                    m_data = static_cast<const unsigned char*>(addr);
+                }
+            }
+
+            ~MappedFile() {
+                if (m_data) {
+                    ::munmap(const_cast<unsigned char*>(m_data), m_size);
+                }
+                ::close(m_fd);
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            const unsigned char* data() const { return m_data; }
+            size_t size() const { return m_size; }
+
+        private:
+            int m_fd = -1;
+            const unsigned char* m_data = nullptr;
+            size_t m_size = 0;
+    };
+
+    // Row vectors (the Adam bias moments) are handed out as their arma::Mat base
+    template <typename eT>
+    const arma::Mat<eT>& layer_tensor(const LayerDenseT<eT>& layer, uint32_t kind) {
+        switch (kind) {
+            case NN_TENSOR_WEIGHTS: return layer.m_weights;
+            case NN_TENSOR_BIASES: return layer.m_biases;
+            case NN_TENSOR_VELOCITY_WEIGHTS: return layer.m_velocity_weights;
+            case NN_TENSOR_VELOCITY_BIASES: return layer.m_velocity_biases;
+            case NN_TENSOR_ADAM_WEIGHT_MOMENTUMS: return layer.m_weight_momentums;
+            case NN_TENSOR_ADAM_WEIGHT_CACHE: return layer.m_weight_cache;
+            case NN_TENSOR_ADAM_BIAS_MOMENTUMS: return layer.m_bias_momentums;
+            default: return layer.m_bias_cache;
+        }
+    }
+
+    template <typename eT>
+    arma::Mat<eT>& layer_tensor(LayerDenseT<eT>& layer, uint32_t kind) {
+        return const_cast<arma::Mat<eT>&>(layer_tensor(static_cast<const LayerDenseT<eT>&>(layer), kind));
+    }
+}
+
+template <typename eT>
+std::vector<char> pack_model(const std::vector<LayerDenseT<eT>>& layers, uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim, 
+    uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type, double optimizer_step) {
+
+    if (layers.empty()) {
+        throw std::runtime_error("No layers to write");
+    }
+
+    // Lay out the directory and the aligned tensor blocks. Adam moments only exist once a
+    // layer has been trained, target networks never have them
+    std::vector<NNTensorEntry> directory;
+    directory.reserve(layers.size() * 8 + 1);
+    for (uint32_t i = 0; i < layers.size(); ++i) {
+        const uint32_t kinds = layers[i].m_weight_momentums.n_elem > 0 ? NN_TENSOR_ADAM_BIAS_CACHE + 1 : NN_TENSOR_VELOCITY_BIASES + 1;
+        for (uint32_t kind = 0; kind < kinds; ++kind) {
+            const auto& matrix = layer_tensor(layers[i], kind);
+            NNTensorEntry entry = {};
+            entry.layer = i;
+            entry.kind = kind;
+            entry.rows = static_cast<uint32_t>(matrix.n_rows);
+            entry.cols = static_cast<uint32_t>(matrix.n_cols);
+            entry.bytes = matrix.n_elem * sizeof(eT);
+            directory.push_back(entry);
+        }
+    }
+    NNTensorEntry step_entry = {};
+    step_entry.kind = NN_TENSOR_OPTIMIZER_STEP;
+    step_entry.rows = 1;
+    step_entry.cols = 1;
+    step_entry.bytes = sizeof(double);
+    directory.push_back(step_entry);
+
+    const uint32_t tensor_count = static_cast<uint32_t>(directory.size());
+    size_t offset = align_up(sizeof(NNCheckpointHeader) + tensor_count * sizeof(NNTensorEntry));
+    for (auto& entry : directory) {
+        entry.offset = offset;
+        offset = align_up(offset + entry.bytes);
+    }
+
+    // The whole file in memory, it goes out in a single write
+    std::vector<char> buffer(offset, 0);
+    std::memcpy(buffer.data() + sizeof(NNCheckpointHeader), directory.data(), tensor_count * sizeof(NNTensorEntry));
+    for (const auto& entry : directory) {
+        if (entry.kind == NN_TENSOR_OPTIMIZER_STEP) {
+            std::memcpy(buffer.data() + entry.offset, &optimizer_step, sizeof(double));
+            continue;
+        }
+        const auto& matrix = layer_tensor(layers[entry.layer], entry.kind);
+        if (entry.bytes > 0) {
+            std::memcpy(buffer.data() + entry.offset, matrix.memptr(), entry.bytes);
+        }
+    }
+
+    NNCheckpointHeader header = {};
+    std::memcpy(header.magic, "NNCKPT", 6);
+    header.version = NN_CHECKPOINT_VERSION;
+    header.header_size = sizeof(NNCheckpointHeader);
+    header.input_dim = input_dim;
+    header.output_dim = output_dim;
+    header.hidden_dim = hidden_dim;
+    header.num_m_layers = num_m_layers;
+    header.batch_size = batch_size;
+    header.nn_type = nn_type;
+    header.precision = sizeof(eT);
+    header.tensor_count = tensor_count;
+    header.directory_offset = sizeof(NNCheckpointHeader);
+    header.checksum = 0; // filled in by write_packed_model
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    return buffer;
+}
+
+bool write_packed_model(const std::string& dirname, std::vector<char>& buffer) {
+    if (buffer.size() < sizeof(NNCheckpointHeader)) {
+        throw std::runtime_error("Checkpoint buffer is truncated");
+    }
+
+    std::error_code dir_error;
+    std::filesystem::create_directories(dirname, dir_error);
+    if (dir_error) {
+        throw std::runtime_error("Failed to create directory: " + dirname + " - " + dir_error.message());
+    }
+    if (!std::filesystem::is_directory(dirname)) {
+        throw std::runtime_error("Path is not a directory: " + dirname);
+    }
+
+    uint64_t checksum = checkpoint_checksum(reinterpret_cast<const unsigned char*>(buffer.data()) + sizeof(NNCheckpointHeader),
+                                            buffer.size() - sizeof(NNCheckpointHeader));
+    std::memcpy(buffer.data() + offsetof(NNCheckpointHeader, checksum), &checksum, sizeof(checksum));
+
+    write_file_atomic((std::filesystem::path(dirname) / NN_CHECKPOINT_FILE).string(), buffer.data(), buffer.size());
+    return true;
+}
+
+template <typename eT>
+bool write_model(const std::string& dirname, const std::vector<LayerDenseT<eT>>& layers, uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim, 
+    uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type, double optimizer_step) {
+
+    std::vector<char> buffer = pack_model(layers, input_dim, output_dim, hidden_dim, num_m_layers, batch_size, nn_type, optimizer_step);
+    return write_packed_model(dirname, buffer);
+}
+
+// Map the checkpoint and copy each tensor once into its layer, converting precision if needed
+template <typename eT>
+static bool read_checkpoint(const std::string& path, std::vector<LayerDenseT<eT>>& layers, NNInfo_metadata& nn_info) {
+    MappedFile file(path);
+    const unsigned char* data = file.data();
+
+    if (file.size() < sizeof(NNCheckpointHeader)) {
+        throw std::runtime_error("Checkpoint is truncated: " + path);
+    }
+    NNCheckpointHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, "NNCKPT", 6) != 0 || header.header_size != sizeof(NNCheckpointHeader)) {
+        throw std::runtime_error("Not a model checkpoint: " + path);
+    }
+    if (header.version < 1 || header.version > NN_CHECKPOINT_VERSION) {
+        throw std::runtime_error("Unsupported checkpoint version " + std::to_string(header.version) + ": " + path);
+    }
+    if (header.precision != sizeof(double) && header.precision != sizeof(float)) {
+        throw std::runtime_error("Unsupported model precision: " + std::to_string(header.precision) + " bytes");
+    }
+    if (header.directory_offset + static_cast<uint64_t>(header.tensor_count) * sizeof(NNTensorEntry) > file.size()) {
+        throw std::runtime_error("Checkpoint directory is truncated: " + path);
+    }
+    if (checkpoint_checksum(data + sizeof(header), file.size() - sizeof(header)) != header.checksum) {
+        throw std::runtime_error("Checkpoint checksum mismatch: " + path);
+    }
+
+    nn_info.input_dim = header.input_dim;
+    nn_info.output_dim = header.output_dim;
+    nn_info.hidden_dim = header.hidden_dim;
+    nn_info.num_m_layers = header.num_m_layers;
+    nn_info.batch_size = header.batch_size;
+    nn_info.nn_type = header.nn_type;
+    nn_info.precision = header.precision;
+    nn_info.optimizer_step = 0.0;
+
+    layers.clear();
+    layers.reserve(nn_info.num_m_layers);
+    for (uint32_t i = 0; i < nn_info.num_m_layers; ++i) {
+        const uint32_t in_dim = (i == 0) ? nn_info.input_dim : nn_info.hidden_dim;
+        const uint32_t out_dim = (i == nn_info.num_m_layers-1) ? nn_info.output_dim : nn_info.hidden_dim;
+        layers.emplace_back(in_dim, out_dim, 0.0, 0.0001, 0.0, 0);
+    }
+
+    for (uint32_t t = 0; t < header.tensor_count; ++t) {
+        NNTensorEntry entry;
+        std::memcpy(&entry, data + header.directory_offset + t * sizeof(NNTensorEntry), sizeof(entry));
+
+        const uint64_t element_size = entry.kind == NN_TENSOR_OPTIMIZER_STEP ? sizeof(double) : header.precision;
+        const uint64_t expected_bytes = static_cast<uint64_t>(entry.rows) * entry.cols * element_size;
+        if (entry.layer >= layers.size() || entry.kind > NN_TENSOR_OPTIMIZER_STEP ||
+            entry.bytes != expected_bytes || entry.offset + entry.bytes > file.size()) {
+            throw std::runtime_error("Corrupt tensor entry " + std::to_string(t) + " in " + path);
+        }
+
+        if (entry.kind == NN_TENSOR_OPTIMIZER_STEP) {
+            if (entry.bytes != sizeof(double)) {
+                throw std::runtime_error("Corrupt optimizer step in " + path);
+            }
+            std::memcpy(&nn_info.optimizer_step, data + entry.offset, sizeof(double));
+            continue;
+        }
+
+        arma::Mat<eT>& target = layer_tensor(layers[entry.layer], entry.kind);
+        if (header.precision == sizeof(eT)) {
+            target = arma::Mat<eT>(reinterpret_cast<const eT*>(data + entry.offset), entry.rows, entry.cols);
+        } else if (header.precision == sizeof(float)) {
+            const arma::Mat<float> stored(const_cast<float*>(reinterpret_cast<const float*>(data + entry.offset)), entry.rows, entry.cols, false, true);
+            target = arma::conv_to<arma::Mat<eT>>::from(stored);
+        } else {
+            const arma::Mat<double> stored(const_cast<double*>(reinterpret_cast<const double*>(data + entry.offset)), entry.rows, entry.cols, false, true);
+            target = arma::conv_to<arma::Mat<eT>>::from(stored);
+        }
+    }
+    return true;
+}
+
+template <typename eT>
+bool read_model(const std::string& dirname, std::vector<LayerDenseT<eT>>& layers, NNInfo_metadata& nn_info) {
+    const std::filesystem::path checkpoint = std::filesystem::path(dirname) / NN_CHECKPOINT_FILE;
+    if (!std::filesystem::exists(checkpoint)) {
+        return read_model_legacy(dirname, layers, nn_info);
+    }
+
+    try {
+        return read_checkpoint(checkpoint.string(), layers, nn_info);
+    } catch(const std::exception& e) {
+        std::cerr << "Load Model Error: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+template bool write_model<double>(const std::string&, const std::vector<LayerDenseT<double>>&, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double);
+template bool write_model<float>(const std::string&, const std::vector<LayerDenseT<float>>&, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double);
+template std::vector<char> pack_model<double>(const std::vector<LayerDenseT<double>>&, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double);
+template std::vector<char> pack_model<float>(const std::vector<LayerDenseT<float>>&, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, uint32_t, double);
+template bool read_model<double>(const std::string&, std::vector<LayerDenseT<double>>&, NNInfo_metadata&);
+template bool read_model<float>(const std::string&, std::vector<LayerDenseT<float>>&, NNInfo_metadata&);
+
 // Helper function to trim whitespace from a string
 std::string trim(const std::string& str) {
     size_t first = str.find_first_not_of(" \t\n\r");
@@ -191,6 +462,10 @@ void parse_params(const std::string& file_path, T& params) {
             current_spec = "DQN_specs";
             continue;
         }
+        if (line.find("Telemetry_specs") != std::string::npos) {
+            current_spec = "Telemetry_specs";
+            continue;
+        }
 
         // If inside a spec block and not the end brace
         if (!current_spec.empty() && line.find('}') == std::string::npos) {
@@ -205,20 +480,28 @@ void parse_params(const std::string& file_path, T& params) {
                 }
 
                 // Check which struct we are populating
-                if (current_spec == "RND_specs" && std::is_same<T, RND_Params>::value) {
-                    if (key == "LR_INITIAL") params.LR_INITIAL = std::stod(value_str);
-                    else if (key == "BETA1") params.BETA1 = std::stod(value_str);
-                    else if (key == "BETA2") params.BETA2 = std::stod(value_str);
-                    else if (key == "EPS") params.EPS = std::stod(value_str);
-                    else if (key == "max_training_steps") params.max_training_steps = std::stoi(value_str);
-                    else if (key == "min_learning_rate") params.min_learning_rate = std::stod(value_str);
-                } else if (current_spec == "DQN_specs" && std::is_same<T, DQN_Params>::value) {
-                    if (key == "LR_INITIAL") params.LR_INITIAL = std::stod(value_str);
-                    else if (key == "BETA1") params.BETA1 = std::stod(value_str);
-                    else if (key == "BETA2") params.BETA2 = std::stod(value_str);
-                    else if (key == "EPS") params.EPS = std::stod(value_str);
-                    else if (key == "max_training_steps") params.max_training_steps = std::stoi(value_str);
-                    else if (key == "min_learning_rate") params.min_learning_rate = std::stod(value_str);
+                if constexpr (std::is_same<T, Telemetry_Params>::value) {
+                    if (current_spec == "Telemetry_specs") {
+                        if (key == "LOSS_LOG_INTERVAL") params.LOSS_LOG_INTERVAL = std::stoi(value_str);
+                        else if (key == "LOSS_LOG_MODE") params.LOSS_LOG_MODE = std::stoi(value_str);
+                        else if (key == "LOSS_FLUSH_LINES") params.LOSS_FLUSH_LINES = std::stoi(value_str);
+                    }
+                } else {
+                    if (current_spec == "RND_specs" && std::is_same<T, RND_Params>::value) {
+                        if (key == "LR_INITIAL") params.LR_INITIAL = std::stod(value_str);
+                        else if (key == "BETA1") params.BETA1 = std::stod(value_str);
+                        else if (key == "BETA2") params.BETA2 = std::stod(value_str);
+                        else if (key == "EPS") params.EPS = std::stod(value_str);
+                        else if (key == "max_training_steps") params.max_training_steps = std::stoi(value_str);
+                        else if (key == "min_learning_rate") params.min_learning_rate = std::stod(value_str);
+                    } else if (current_spec == "DQN_specs" && std::is_same<T, DQN_Params>::value) {
+                        if (key == "LR_INITIAL") params.LR_INITIAL = std::stod(value_str);
+                        else if (key == "BETA1") params.BETA1 = std::stod(value_str);
+                        else if (key == "BETA2") params.BETA2 = std::stod(value_str);
+                        else if (key == "EPS") params.EPS = std::stod(value_str);
+                        else if (key == "max_training_steps") params.max_training_steps = std::stoi(value_str);
+                        else if (key == "min_learning_rate") params.min_learning_rate = std::stod(value_str);
+                    }
                 }
             }
         }
@@ -261,4 +544,22 @@ bool parse_dqn_params(const std::string& param_file_path, DQN_Params& dqn_params
         std::cerr << "Load NN Param Error: " << e.what() << std::endl;
         return false;
     }
-}
\ No newline at end of file
+}
+bool parse_telemetry_params(const std::string& param_file_path, Telemetry_Params& telemetry_params) {
+    namespace fs = std::filesystem;
+    
+    try {
+        // Check if param file exists
+        fs::path file_path = fs::path(param_file_path) / "nn_system.params";
+        if (!fs::exists(file_path)) {
+            throw std::runtime_error("NN System Params not found: " + file_path.string());
+        }
+
+        parse_params(file_path.string(), telemetry_params);
+        
+        return true;
+    } catch(const std::exception& e) {
+        std::cerr << "Load NN Param Error: " << e.what() << std::endl;
+        return false;
+    }
+}
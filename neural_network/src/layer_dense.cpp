@@ -1,6 +1,9 @@
 #include <layer_dense.h>
+#include <algorithm>
+#include <stdexcept>
 
-LayerDense::LayerDense(uint32_t n_inputs, uint32_t n_neurons, double weight_regularizer_L1, double weight_regularizer_L2, 
+template <typename eT>
+LayerDenseT<eT>::LayerDenseT(uint32_t n_inputs, uint32_t n_neurons, double weight_regularizer_L1, double weight_regularizer_L2, 
     double bias_regularizer_L1, double bias_regularizer_L2) :
     n_inputs(n_inputs), n_neurons(n_neurons),
     m_weight_regularizer_L1(weight_regularizer_L1),
@@ -8,24 +11,28 @@ LayerDense::LayerDense(uint32_t n_inputs, uint32_t n_neurons, double weight_regu
     m_bias_regularizer_L1(bias_regularizer_L1),
     m_bias_regularizer_L2(bias_regularizer_L2) {    
 
-    m_velocity_weights = arma::zeros<arma::mat>(n_inputs, n_neurons);
-    m_velocity_biases = arma::zeros<arma::mat>(1, n_neurons);
+    m_velocity_weights = arma::zeros<mat_type>(n_inputs, n_neurons);
+    m_velocity_biases = arma::zeros<mat_type>(1, n_neurons);
 }
 
-void LayerDense::reset() {
+template <typename eT>
+void LayerDenseT<eT>::reset() {
     //m_inputs.reset();
     //m_output.reset();
 }
 
-void LayerDense::set_weights(arma::mat weights) {
+template <typename eT>
+void LayerDenseT<eT>::set_weights(mat_type weights) {
     m_weights = weights;
 }
 
-void LayerDense::set_biases(arma::mat biases) {
+template <typename eT>
+void LayerDenseT<eT>::set_biases(mat_type biases) {
     m_biases = biases;
 }
 
-void LayerDense::forward(arma::mat inputs) {
+template <typename eT>
+void LayerDenseT<eT>::forward(mat_type inputs) {
     m_inputs = inputs;
     if (inputs.n_cols != m_weights.n_rows) {
         std::cerr << "Error: Input size does not match weights size" << std::endl;
@@ -38,31 +45,65 @@ void LayerDense::forward(arma::mat inputs) {
     m_output.each_row() += m_biases;
 }
 
-void LayerDense::backward(arma::mat dvalues) {
-    m_dweights = dvalues.t() * m_inputs; // Gradient w.r.t. weights
+template <typename eT>
+void LayerDenseT<eT>::forward_inference(const mat_type& inputs_t, mat_type& outputs_t) const {
+    // outputs^T = W^T * inputs^T + b^T, gemm with a transposed A so no copy of the weights
+    outputs_t = m_weights.t() * inputs_t;
+
+    const arma::Col<eT> biases(const_cast<eT*>(m_biases.memptr()), m_biases.n_elem, false, true);
+    outputs_t.each_col() += biases;
+}
+
+// dst += tau * (src - dst) in one pass, a plain loop over contiguous memory that the
+// compiler vectorizes
+template <typename eT>
+static void polyak_sweep(eT* dst, const eT* src, size_t n, eT tau) {
+    for (size_t i = 0; i < n; ++i) {
+        dst[i] += tau * (src[i] - dst[i]);
+    }
+}
+
+template <typename eT>
+void LayerDenseT<eT>::blend_parameters(const LayerDenseT& source, double tau) {
+    if (m_weights.n_rows != source.m_weights.n_rows || m_weights.n_cols != source.m_weights.n_cols ||
+        m_biases.n_elem != source.m_biases.n_elem) {
+        throw std::invalid_argument("blend_parameters: layer shapes do not match");
+    }
+
+    if (tau >= 1.0) {
+        std::copy(source.m_weights.memptr(), source.m_weights.memptr() + m_weights.n_elem, m_weights.memptr());
+        std::copy(source.m_biases.memptr(), source.m_biases.memptr() + m_biases.n_elem, m_biases.memptr());
+        return;
+    }
+
+    polyak_sweep(m_weights.memptr(), source.m_weights.memptr(), m_weights.n_elem, static_cast<eT>(tau));
+    polyak_sweep(m_biases.memptr(), source.m_biases.memptr(), m_biases.n_elem, static_cast<eT>(tau));
+}
+
+template <typename eT>
+void LayerDenseT<eT>::backward(mat_type dvalues) {
+    m_dweights = m_inputs.t() * dvalues; // Gradient w.r.t. weights, same n_inputs x n_neurons layout as m_weights
     m_dbiases = arma::sum(dvalues, 0);   // Gradient w.r.t. biases
 
     // Regularization gradients
     if (m_weight_regularizer_L1 > 0) {
-        arma::mat temp = m_weight_regularizer_L1 * arma::sign(m_weights);
-        m_dweights += temp.t();
+        m_dweights += static_cast<eT>(m_weight_regularizer_L1) * arma::sign(m_weights);
     }
     if (m_weight_regularizer_L2 > 0) {
-        arma::mat temp = 2.0 * m_weight_regularizer_L2 * m_weights;
-        m_dweights += temp.t();
+        m_dweights += static_cast<eT>(2.0 * m_weight_regularizer_L2) * m_weights;
     }
     if (m_bias_regularizer_L1 > 0) {
-        m_dbiases += m_bias_regularizer_L1 * arma::sign(m_biases);
+        m_dbiases += static_cast<eT>(m_bias_regularizer_L1) * arma::sign(m_biases);
     }
     if (m_bias_regularizer_L2 > 0) {
-        m_dbiases += 2.0 * m_bias_regularizer_L2 * m_biases;
+        m_dbiases += static_cast<eT>(2.0 * m_bias_regularizer_L2) * m_biases;
     }
 
     // Calculate gradient w.r.t. inputs
     m_dinputs = dvalues * m_weights.t(); // Total influence, sum all of these contributions for neurons m in layer l+1
 
-    m_dweights = arma::clamp(m_dweights, -1.0, 1.0);
-    m_dbiases = arma::clamp(m_dbiases, -1.0, 1.0);
+    m_dweights = arma::clamp(m_dweights, eT(-1), eT(1));
+    m_dbiases = arma::clamp(m_dbiases, eT(-1), eT(1));
 
     // Log the gradients
     /*if (m_gradient_counter < 100) {
@@ -75,7 +116,8 @@ void LayerDense::backward(arma::mat dvalues) {
     }*/
 }
 
-    LayerDense::LayerDense(const LayerDense& other)
+    template <typename eT>
+    LayerDenseT<eT>::LayerDenseT(const LayerDenseT& other)
     : n_inputs               (other.n_inputs)
     , n_neurons              (other.n_neurons)
     , m_output               (other.m_output)
@@ -99,3 +141,6 @@ void LayerDense::backward(arma::mat dvalues) {
     {
         // All members initialized above; no body needed
     }
+
+template class LayerDenseT<double>;
+template class LayerDenseT<float>;
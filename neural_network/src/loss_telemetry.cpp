@@ -0,0 +1,106 @@
+#include <loss_telemetry.h>
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+
+LossTelemetry::~LossTelemetry() {
+    flush();
+}
+
+bool LossTelemetry::open(const std::string& path, const Telemetry_Params& params, bool append) {
+    m_params = params;
+    m_params.LOSS_LOG_INTERVAL = std::max(1, m_params.LOSS_LOG_INTERVAL);
+    m_params.LOSS_FLUSH_LINES = std::max(1, m_params.LOSS_FLUSH_LINES);
+
+    m_file.open(path, std::ios::out | (append ? std::ios::app : std::ios::trunc));
+    if (!m_file.is_open()) {
+        return false;
+    }
+    m_buffer.reserve(static_cast<size_t>(m_params.LOSS_FLUSH_LINES) * 48);
+    return true;
+}
+
+// The step ending a sample interval / aggregation window
+bool LossTelemetry::closesRecord() const {
+    return (m_step + 1) % static_cast<uint64_t>(m_params.LOSS_LOG_INTERVAL) == 0;
+}
+
+void LossTelemetry::record(double data_loss, double reg_loss) {
+    char line[128];
+    int length;
+
+    if (m_params.LOSS_LOG_MODE == 1) {
+        if (m_count == 0) {
+            m_min = m_max = data_loss;
+        }
+        m_sum += data_loss;
+        m_min = std::min(m_min, data_loss);
+        m_max = std::max(m_max, data_loss);
+        m_count++;
+
+        if (!closesRecord()) {
+            return;
+        }
+        length = std::snprintf(line, sizeof(line), "%llu %g %g %g\n", static_cast<unsigned long long>(m_step + 1),
+            m_sum / m_count + reg_loss, m_min + reg_loss, m_max + reg_loss);
+        m_sum = 0.0;
+        m_count = 0;
+    } else {
+        length = std::snprintf(line, sizeof(line), "%llu %g\n", static_cast<unsigned long long>(m_step + 1), data_loss + reg_loss);
+    }
+
+    appendLine(line, length);
+}
+
+void LossTelemetry::appendLine(const char* line, int length) {
+    m_buffer.append(line, length);
+    if (++m_buffered_lines >= static_cast<uint32_t>(m_params.LOSS_FLUSH_LINES)) {
+        flush();
+    }
+}
+
+void LossTelemetry::flush() {
+    if (!m_file.is_open() || m_buffer.empty()) {
+        return;
+    }
+    m_file.write(m_buffer.data(), m_buffer.size());
+    m_file.flush();
+    m_buffer.clear();
+    m_buffered_lines = 0;
+}
+
+// Every loss log path opened in this process, true while a network holds it
+static std::mutex s_claims_mutex;
+static std::unordered_map<std::string, bool> s_claims;
+
+LossLogClaim::~LossLogClaim() {
+    if (m_path.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(s_claims_mutex);
+    s_claims[m_path] = false;
+}
+
+bool LossLogClaim::claim(const std::string& base_path) {
+    const size_t dot = base_path.rfind('.');
+    const size_t slash = base_path.rfind('/');
+    const bool has_ext = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+    const std::string stem = has_ext ? base_path.substr(0, dot) : base_path;
+    const std::string ext = has_ext ? base_path.substr(dot) : "";
+
+    std::lock_guard<std::mutex> lock(s_claims_mutex);
+    for (int n = 1; ; ++n) {
+        std::string path = n == 1 ? base_path : stem + "_" + std::to_string(n) + ext;
+        auto it = s_claims.find(path);
+        if (it != s_claims.end() && it->second) {
+            continue; // another network writes there
+        }
+
+        const bool seen = it != s_claims.end();
+        s_claims[path] = true;
+        m_path = std::move(path);
+        return seen;
+    }
+}
@@ -1,26 +1,29 @@
 #include <loss_utils.h>
 
-double mse_loss(const arma::mat& acc, const arma::mat& pred) {
+template <typename eT>
+double mse_loss(const arma::Mat<eT>& acc, const arma::Mat<eT>& pred) {
     if (acc.n_rows != pred.n_rows || acc.n_cols != pred.n_cols) {
         std::cerr << "Error: Input size does not match weights size" << std::endl;
         return std::numeric_limits<double>::quiet_NaN();
     }
 
-    arma::mat diff = acc - pred;
-    double loss = arma::accu(diff % diff) / diff.n_elem;
+    arma::Mat<eT> diff = acc - pred;
+    double loss = static_cast<double>(arma::accu(diff % diff)) / diff.n_elem;
     return loss;
 }
 
-arma::mat derivative_mse_loss(const arma::mat& acc, const arma::mat& pred) {
+template <typename eT>
+arma::Mat<eT> derivative_mse_loss(const arma::Mat<eT>& acc, const arma::Mat<eT>& pred) {
     if (acc.n_rows != pred.n_rows || acc.n_cols != pred.n_cols) {
         throw std::invalid_argument("Input matrices must have same dimensions");
     }
     
-    arma::mat diff = acc - pred;
-    return (2.0 * diff) / diff.n_elem; // (∂L/∂output) for MSE
+    arma::Mat<eT> diff = acc - pred;
+    return (eT(2) * diff) / static_cast<eT>(diff.n_elem); // (∂L/∂output) for MSE
 }
 
-double regularization_loss(const LayerDense& layer) {
+template <typename eT>
+double regularization_loss(const LayerDenseT<eT>& layer) {
     double loss = 0.0;
 
     if (layer.m_weight_regularizer_L1 > 0) {
@@ -39,41 +42,54 @@ double regularization_loss(const LayerDense& layer) {
     return loss;
 }
 
-double huber_loss(const arma::mat& predictions, const arma::mat& targets, double delta) {
+template <typename eT>
+double huber_loss(const arma::Mat<eT>& predictions, const arma::Mat<eT>& targets, double delta) {
     // Calculate the element-wise difference
-    arma::mat diff = predictions - targets;
-    arma::mat abs_diff = arma::abs(diff);
+    arma::Mat<eT> diff = predictions - targets;
+    arma::Mat<eT> abs_diff = arma::abs(diff);
 
-    // Create a boolean mask for the two cases
-    arma::umat small_error_mask = (abs_diff <= delta);
-    arma::umat large_error_mask = (abs_diff > delta);
+    // Create masks for the two cases, in eT so they can scale the losses directly
+    arma::Mat<eT> small_error_mask = arma::conv_to<arma::Mat<eT>>::from(abs_diff <= static_cast<eT>(delta));
+    arma::Mat<eT> large_error_mask = eT(1) - small_error_mask;
 
     // Calculate the loss for each case
-    arma::mat small_loss = 0.5 * arma::square(diff);
-    arma::mat large_loss = delta * (abs_diff - 0.5 * delta);
+    arma::Mat<eT> small_loss = eT(0.5) * arma::square(diff);
+    arma::Mat<eT> large_loss = static_cast<eT>(delta) * (abs_diff - static_cast<eT>(0.5 * delta));
 
     // Combine the two parts using the masks
-    arma::mat combined_loss = small_loss % small_error_mask + large_loss % large_error_mask;
+    arma::Mat<eT> combined_loss = small_loss % small_error_mask + large_loss % large_error_mask;
 
     // Return the mean of the combined loss
-    return arma::accu(combined_loss) / (predictions.n_elem);
+    return static_cast<double>(arma::accu(combined_loss)) / (predictions.n_elem);
 }
 
-arma::mat derivative_huber_loss(const arma::mat& predictions, const arma::mat& targets, double delta) {
+template <typename eT>
+arma::Mat<eT> derivative_huber_loss(const arma::Mat<eT>& predictions, const arma::Mat<eT>& targets, double delta) {
     // Calculate the element-wise difference
-    arma::mat diff = predictions - targets;
-    arma::mat abs_diff = arma::abs(diff);
+    arma::Mat<eT> diff = predictions - targets;
+    arma::Mat<eT> abs_diff = arma::abs(diff);
 
-    // Create a boolean mask for the two cases
-    arma::umat small_error_mask = (abs_diff <= delta);
-    arma::umat large_error_mask = (abs_diff > delta);
+    // Create masks for the two cases, in eT so they can scale the derivatives directly
+    arma::Mat<eT> small_error_mask = arma::conv_to<arma::Mat<eT>>::from(abs_diff <= static_cast<eT>(delta));
+    arma::Mat<eT> large_error_mask = eT(1) - small_error_mask;
 
     // Calculate the derivative for each case
-    arma::mat small_deriv = diff;
-    arma::mat large_deriv = delta * arma::sign(diff);
+    arma::Mat<eT> small_deriv = diff;
+    arma::Mat<eT> large_deriv = static_cast<eT>(delta) * arma::sign(diff);
 
     // Combine the two parts using the masks
-    arma::mat combined_deriv = small_deriv % small_error_mask + large_deriv % large_error_mask;
+    arma::Mat<eT> combined_deriv = small_deriv % small_error_mask + large_deriv % large_error_mask;
 
     return combined_deriv;
-}
\ No newline at end of file
+}
+
+template double mse_loss<double>(const arma::Mat<double>&, const arma::Mat<double>&);
+template double mse_loss<float>(const arma::Mat<float>&, const arma::Mat<float>&);
+template arma::Mat<double> derivative_mse_loss<double>(const arma::Mat<double>&, const arma::Mat<double>&);
+template arma::Mat<float> derivative_mse_loss<float>(const arma::Mat<float>&, const arma::Mat<float>&);
+template double regularization_loss<double>(const LayerDenseT<double>&);
+template double regularization_loss<float>(const LayerDenseT<float>&);
+template double huber_loss<double>(const arma::Mat<double>&, const arma::Mat<double>&, double);
+template double huber_loss<float>(const arma::Mat<float>&, const arma::Mat<float>&, double);
+template arma::Mat<double> derivative_huber_loss<double>(const arma::Mat<double>&, const arma::Mat<double>&, double);
+template arma::Mat<float> derivative_huber_loss<float>(const arma::Mat<float>&, const arma::Mat<float>&, double);
@@ -5,16 +5,62 @@
 #include <armadillo>
 #include <vector>
 #include <memory>
+#include <type_traits>
+#include <atomic>
+#include <functional>
+#include <algorithm>
 #include <io.h>
+#include <loss_telemetry.h>
+#include <checkpoint_writer.h>
+#include <inference_pool.h>
 
+// What parse_nn_params read from nn_system.params. Only nn_default_options and the id-based
+// shim read these, a network keeps the nn_options it was created with
 RND_Params rnd_params;
 DQN_Params dqn_params;
+Telemetry_Params telemetry_params;
 
-class NeuralNetwork {
+extern "C" {
+    // Per-network configuration, same layout as in the game's nn_api.h
+    struct nn_options {
+        double lr_initial;
+        double beta1;
+        double beta2;
+        double eps;
+        int32_t max_training_steps;
+        double min_learning_rate;
+
+        int32_t loss_log_interval;
+        int32_t loss_log_mode;
+        int32_t loss_flush_lines;
+    };
+}
+
+inline Telemetry_Params loss_log_params(const nn_options& options) {
+    Telemetry_Params params;
+    params.LOSS_LOG_INTERVAL = options.loss_log_interval;
+    params.LOSS_LOG_MODE = options.loss_log_mode;
+    params.LOSS_FLUSH_LINES = options.loss_flush_lines;
+    return params;
+}
+
+// Source of parameter versions. Unique across all instances, so a network that is reloaded
+// or rebuilt never reports a version some cache was tagged with before
+std::atomic<uint64_t> g_param_version{0};
+
+inline uint64_t next_param_version() {
+    return g_param_version.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+// eT is the element type of every layer, double or float (see NeuralNetwork/NeuralNetworkF)
+template <typename eT>
+class NeuralNetworkT {
 
     public:
-        std::vector<LayerDense> m_layers;
-        std::vector<Activation_ReLU_Leaky> m_activations;
+        using mat_type = arma::Mat<eT>;
+
+        std::vector<LayerDenseT<eT>> m_layers;
+        std::vector<Activation_ReLU_LeakyT<eT>> m_activations;
         //Optimizer_SGD optimizer;
         Optimizer_Adam optimizer;
 
@@ -25,19 +71,33 @@ class NeuralNetwork {
         uint32_t m_output_dim;
         uint32_t m_hidden_dim;
 
-        std::ofstream m_log_file;
+        nn_options m_options; // hyperparameters and loss log settings, fixed at creation
+        // loss log, online and RND predictor only. The claim outlives the telemetry, so the
+        // file is closed before another network may take it
+        LossLogClaim m_loss_log;
+        LossTelemetry m_telemetry;
+
+        // Changes whenever the weights do (training, randomizing, loading, syncing). Copies
+        // share it, their weights are the same
+        uint64_t m_param_version = next_param_version();
+
+        // Ping-pong buffers for predict, each big enough for the widest layer at the largest
+        // batch seen so far. Only grown, so steady-state inference does not allocate
+        arma::Col<eT> m_infer_buffers[2];
+        uint32_t m_infer_capacity = 0;
 
-        NeuralNetwork(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim, 
+        NeuralNetworkT(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim, 
                     uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type, 
-                    double initial_lr, double beta1, double beta2, 
-                    double eps, int max_steps, double min_lr) :
-            optimizer(initial_lr, beta1, beta2, eps, 0.0, max_steps, min_lr),
+                    const nn_options& options) :
+            optimizer(options.lr_initial, options.beta1, options.beta2, options.eps, 0.0,
+                      options.max_training_steps, options.min_learning_rate),
             m_nn_type(nn_type),
             m_batch_size(batch_size),
             m_input_dim(input_dim),
             num_layers(num_m_layers),
             m_output_dim(output_dim),
-            m_hidden_dim(hidden_dim)
+            m_hidden_dim(hidden_dim),
+            m_options(options)
         {
             // Validate parameters
             if (num_m_layers < 3) {
@@ -56,22 +116,22 @@ class NeuralNetwork {
             // Create input layer directly in vector
             m_layers.emplace_back(input_dim, hidden_dim, 0.0, 0.0001, 0.0, 0);
             auto& input_layer = m_layers.back();
-            input_layer.set_weights(arma::randn<arma::mat>(input_dim,hidden_dim) * std::sqrt(2.0/7));
-            input_layer.set_biases(arma::mat(1, hidden_dim, arma::fill::value(0.1)));
+            input_layer.set_weights(arma::randn<mat_type>(input_dim,hidden_dim) * std::sqrt(2.0/7));
+            input_layer.set_biases(mat_type(1, hidden_dim, arma::fill::value(0.1)));
 
             // Create hidden layers
             for (uint32_t i = 0; i < num_m_layers - 2; ++i) {
                 m_layers.emplace_back(hidden_dim, hidden_dim, 0.0, 5e-5, 0.0, 0);
                 auto& layer = m_layers.back();
-                layer.set_weights(arma::randn<arma::mat>(hidden_dim,hidden_dim) * std::sqrt(2.0/hidden_dim));
-                layer.set_biases(arma::mat(1, hidden_dim, arma::fill::value(0.1)));
+                layer.set_weights(arma::randn<mat_type>(hidden_dim,hidden_dim) * std::sqrt(2.0/hidden_dim));
+                layer.set_biases(mat_type(1, hidden_dim, arma::fill::value(0.1)));
             }
 
             // Create output layer
             m_layers.emplace_back(hidden_dim, output_dim, 0.0, 5e-5, 0.0, 0);
             auto& output_layer = m_layers.back();
-            output_layer.set_weights(arma::randn<arma::mat>(hidden_dim,output_dim) * std::sqrt(2.0/output_dim));
-            output_layer.set_biases(arma::mat(1, output_dim, arma::fill::value(0.1)));
+            output_layer.set_weights(arma::randn<mat_type>(hidden_dim,output_dim) * std::sqrt(2.0/output_dim));
+            output_layer.set_biases(mat_type(1, output_dim, arma::fill::value(0.1)));
 
             // Create activations
             for (uint32_t i = 0; i < num_m_layers - 1; ++i) {
@@ -95,16 +155,10 @@ class NeuralNetwork {
 
             if (!filename.empty()) {
                 std::filesystem::create_directory("logs");
-                std::string full_path = "logs/" + filename; 
-                
-                // Add this line to ensure a clean file for logging
-                if (std::filesystem::exists(full_path)) {
-                    std::filesystem::remove(full_path);
-                }
-
-                m_log_file.open(full_path, std::ios::app);
+                bool append = m_loss_log.claim("logs/" + filename);
+                const std::string& full_path = m_loss_log.path();
 
-                if (!m_log_file.is_open()) {
+                if (!m_telemetry.open(full_path, loss_log_params(m_options), append)) {
                     std::cerr << "Error: Could not open log file " << full_path << ". Reason: " << strerror(errno) << std::endl;
                     // It is safer to exit or throw here, as logging won't work otherwise.
                 } else {
@@ -114,20 +168,18 @@ class NeuralNetwork {
 
         }
 
-        ~NeuralNetwork() {
-            if (m_log_file.is_open()) {
-                m_log_file.close();
-            }
-        }
+        ~NeuralNetworkT() = default;
 
-        NeuralNetwork(const NeuralNetwork& other) :
+        NeuralNetworkT(const NeuralNetworkT& other) :
             optimizer(other.optimizer),
             m_nn_type(other.m_nn_type),
             m_batch_size(other.m_batch_size),
             m_input_dim(other.m_input_dim),
             num_layers(other.num_layers),
             m_output_dim(other.m_output_dim),
-            m_hidden_dim(other.m_hidden_dim)
+            m_hidden_dim(other.m_hidden_dim),
+            m_options(other.m_options),
+            m_param_version(other.m_param_version)
         {
             // Reserve space first
             m_layers.reserve(other.m_layers.size());
@@ -163,7 +215,7 @@ class NeuralNetwork {
             }
         }
 
-        void predict(double* input_data, double* output_data, uint32_t batch_size) {
+        void predict(eT* input_data, eT* output_data, uint32_t batch_size) {
 
             if (input_data == nullptr) {
                 std::cerr << "Error: input_data is null" << std::endl;
@@ -175,44 +227,78 @@ class NeuralNetwork {
                 return;
             }
 
-            arma::mat inputs(input_data, m_input_dim, batch_size, true);
-            inputs = inputs.t(); // Transpose to match the expected input shape
+            if (output_data == nullptr) {
+                std::cerr << "Error: output_data is null" << std::endl;
+                return;
+            }
 
-            for (int i = 0; i < m_layers.size() - 1; ++i) {
-                m_layers[i].forward(inputs);
-                m_activations[i].forward(m_layers[i].m_output);
+            reserve_inference(batch_size);
 
-                // set inputs for next layer
-                inputs = m_activations[i].m_output;
-                // print check
-            }
+            // No backward pass follows, so run feature-major (one column per sample) without
+            // caching anything in the layers. Sample-major input_data already is the
+            // transposed input matrix, so it is used in place
+            eT* current = input_data;
+            arma::uword current_dim = m_input_dim;
 
-            // Forward pass through the last layer
-            m_layers.back().forward(inputs);
+            for (size_t i = 0; i + 1 < m_layers.size(); ++i) {
+                // views over existing memory, constructing them does not allocate
+                const mat_type inputs_t(current, current_dim, batch_size, false, true);
+                mat_type hidden_t(m_infer_buffers[i % 2].memptr(), m_layers[i].m_weights.n_cols, batch_size, false, true);
 
+                m_layers[i].forward_inference(inputs_t, hidden_t);
+                m_activations[i].forward_inplace(hidden_t);
 
-            // output is in m_activations[m_activations.size() - 1].m_output
-            arma::mat& output = m_layers.back().m_output;
-            if (output_data == nullptr) {
-                std::cerr << "Error: output_data is null" << std::endl;
-                return;
+                current = hidden_t.memptr();
+                current_dim = hidden_t.n_rows;
             }
 
+            // Last layer writes straight into the caller's buffer, which in feature-major
+            // form is the sample-major layout callers index as output_data[i * output_dim + k]
+            const mat_type inputs_t(current, current_dim, batch_size, false, true);
+            mat_type output(output_data, m_output_dim, batch_size, false, true);
+            m_layers.back().forward_inference(inputs_t, output);
+
             // check if output has NaN or infinite values
             if (output.has_nan() || output.has_inf()) {
                 std::cerr << "Error: Output contains NaN or infinite values." << std::endl;
                 std::cerr << "Output matrix: " << output << std::endl;
                 exit(1);
             }
+        }
+
+        void reserve_inference(uint32_t batch_size) {
+            if (batch_size <= m_infer_capacity) {
+                return;
+            }
+
+            arma::uword max_width = 0;
+            for (const auto& layer : m_layers) {
+                max_width = std::max(max_width, layer.m_weights.n_cols);
+            }
 
-            // Convert Armadillo matrix to double* (copy data)
-            std::memcpy(output_data, output.memptr(), output.n_elem * sizeof(double));
+            m_infer_buffers[0].set_size(max_width * batch_size);
+            m_infer_buffers[1].set_size(max_width * batch_size);
+            m_infer_capacity = batch_size;
         }
 
 
-        void train(double* input_data, double* target_data) {
-            arma::mat inputs(input_data, m_input_dim, m_batch_size, true);
-            inputs = inputs.t(); // Transpose to match the expected input shape
+        // sample_weights (optional, one per sample) scale each sample's gradient, e.g. the
+        // importance-sampling weights of prioritized replay. The logged loss stays unweighted
+        // Trains on batch_size samples, which may differ from the batch size the network was
+        // created with (that one is only recorded in checkpoints)
+        void train(eT* input_data, eT* target_data, uint32_t batch_size, const eT* sample_weights = nullptr) {
+            if (input_data == nullptr || target_data == nullptr) {
+                std::cerr << "Error: training data is null" << std::endl;
+                return;
+            }
+            if (batch_size == 0) {
+                std::cerr << "Error: training batch is empty" << std::endl;
+                return;
+            }
+
+            // Read the caller's batch in place, the transpose is the only copy
+            const mat_type input_view(input_data, m_input_dim, batch_size, false, true);
+            mat_type inputs = input_view.t(); // Transpose to match the expected input shape
 
             for (int i = 0; i < m_layers.size() - 1; ++i) {
                 m_layers[i].forward(inputs);
@@ -224,36 +310,39 @@ class NeuralNetwork {
             // Forward pass through the last layer
             m_layers.back().forward(inputs);
 
-            arma::mat expected_output(target_data, m_layers.back().m_output.n_rows, m_layers.back().m_output.n_cols, true, false);
+            // target_data is sample-major like predict's output
+            mat_type expected_output = mat_type(target_data, m_layers.back().m_output.n_cols, m_layers.back().m_output.n_rows, false, true).t();
 
             //double loss = mse_loss(m_layers.back().m_output, expected_output);
 
             const double huber_delta = 1.0;
-            double loss = huber_loss(m_layers.back().m_output, expected_output, huber_delta);
 
-            double reg_val = 0.0;
-            for (const auto& layer : m_layers) {
-                reg_val += regularization_loss(layer);  // your function
-            }
-            double total_loss = loss + reg_val;
+            // The loss value is only telemetry, skip it (and the regularization sweep over every
+            // layer) on steps that don't end up in the log
+            if (m_telemetry.wantsLoss()) {
+                double loss = huber_loss(m_layers.back().m_output, expected_output, huber_delta);
 
-            if (m_log_file.is_open() && (m_nn_type == 0 || m_nn_type == 2)) {
-                m_log_file << total_loss << std::endl;
-                m_log_file.flush();
+                double reg_val = 0.0;
+                if (m_telemetry.wantsRegularization()) {
+                    for (const auto& layer : m_layers) {
+                        reg_val += regularization_loss(layer);
+                    }
+                }
+                m_telemetry.record(loss, reg_val);
             }
-
-            // if nn_type is 0 write hello to log file
-            /*if (m_log_file.is_open() && m_log_file.good()) {
-                // If nn_type is 0 (online) or 2 (RND predictor) log the loss
-                m_log_file << std::setprecision(5) << loss << std::endl;
-                m_log_file.flush();
-            }*/
+            m_telemetry.advance();
 
             //arma::mat d_loss = derivative_mse_loss(m_layers.back().m_output, expected_output);
-            arma::mat d_loss = derivative_huber_loss(m_layers.back().m_output, expected_output, huber_delta);
+            mat_type d_loss = derivative_huber_loss(m_layers.back().m_output, expected_output, huber_delta);
+
+            if (sample_weights != nullptr) {
+                // d_loss has one row per sample
+                const arma::Col<eT> weights(const_cast<eT*>(sample_weights), d_loss.n_rows, false, true);
+                d_loss.each_col() %= weights;
+            }
 
             m_layers.back().backward(d_loss);
-            arma::mat d_act;
+            mat_type d_act;
             
             for (int i = m_layers.size() - 2; i >= 0; --i) {
                 d_act = m_activations[i].backward(m_layers[i + 1].m_dinputs);
@@ -265,43 +354,429 @@ class NeuralNetwork {
             for (int i = 0; i < m_layers.size(); ++i) {
                 optimizer.update(m_layers[i]);
             }
-
-            /*if (m_log_file.is_open() && (m_nn_type == 0 || m_nn_type == 2)) {
-                m_log_file << loss << std::endl;
-                m_log_file.flush();
-            }*/
+            m_param_version = next_param_version();
 
         }
 
         bool save_model(const std::string& dirname) {
-            return write_model(dirname, m_layers, m_input_dim, m_output_dim, m_hidden_dim, m_layers.size(), m_batch_size, m_nn_type);
+            m_telemetry.flush(); // loss log on disk up to the checkpoint
+            return write_model(dirname, m_layers, m_input_dim, m_output_dim, m_hidden_dim, m_layers.size(), m_batch_size, m_nn_type, optimizer.m_step);
+        }
+
+        // Copies the parameters into a checkpoint buffer and leaves the disk work to the writer thread
+        uint64_t save_model_async(const std::string& dirname) {
+            m_telemetry.flush();
+            std::vector<char> buffer = pack_model(m_layers, m_input_dim, m_output_dim, m_hidden_dim, m_layers.size(), m_batch_size, m_nn_type, optimizer.m_step);
+            return CheckpointWriter::getInstance().submit(dirname, std::move(buffer));
         }
 
-        uint32_t randomize_weights(std::vector<LayerDense>& layers) {
+        uint32_t randomize_weights(std::vector<LayerDenseT<eT>>& layers) {
             for (auto& layer : layers) {
                 layer.m_weights.randu();
                 layer.m_biases.randu();
             }
+            m_param_version = next_param_version();
             
             return 0;
         }
         
 };
 
+using NeuralNetwork = NeuralNetworkT<double>;
+using NeuralNetworkF = NeuralNetworkT<float>;
+
+// What an nn_network handle points to: one network, double or float, with everything it owns
+// (parameters, Adam state, inference buffers, loss log). The handle entry points only touch the
+// networks they are given, so networks behind different handles can be used from different
+// threads without any locking
+struct nn_network {
+    std::unique_ptr<NeuralNetwork> f64;
+    std::unique_ptr<NeuralNetworkF> f32;
+};
+
+template <typename eT>
+std::unique_ptr<NeuralNetworkT<eT>>& network_slot(nn_network* handle) {
+    if constexpr (std::is_same_v<eT, float>) {
+        return handle->f32;
+    } else {
+        return handle->f64;
+    }
+}
+
+// The network behind handle, exits on a null handle or one of the other precision
+template <typename eT>
+NeuralNetworkT<eT>& as_network(nn_network* handle) {
+    if (handle == nullptr) {
+        std::cerr << "Error: Null neural network handle" << std::endl;
+        exit(1);
+    }
+    auto& slot = network_slot<eT>(handle);
+    if (!slot) {
+        std::cerr << "Error: Neural network handle holds a "
+                  << (std::is_same_v<eT, float> ? "float64" : "float32") << " network" << std::endl;
+        exit(1);
+    }
+    return *slot;
+}
+
+// Calls fn with the network behind handle, whichever precision it is
+template <typename Fn>
+auto with_network(nn_network* handle, Fn&& fn) {
+    if (handle != nullptr && handle->f32) {
+        return fn(*handle->f32);
+    }
+    return fn(as_network<double>(handle));
+}
+
+// Id-based API, kept as a shim over handles: instance id of nn_type is the handle at that
+// index. The handle API itself never touches these
 extern "C" {
-    std::vector<std::unique_ptr<NeuralNetwork>> nn_online_instances; // id 0
-    std::vector<std::unique_ptr<NeuralNetwork>> nn_target_instances; // id 1
+    std::vector<std::unique_ptr<nn_network>> nn_online_instances; // id 0
+    std::vector<std::unique_ptr<nn_network>> nn_target_instances; // id 1
 
     // vector of nn for RND -> predictor
-    std::vector<std::unique_ptr<NeuralNetwork>> nn_rnd_instances; // id 2
+    std::vector<std::unique_ptr<nn_network>> nn_rnd_instances; // id 2
     // vector of nn for RND -> target
-    std::vector<std::unique_ptr<NeuralNetwork>> nn_rnd_target_instances; // id 3
+    std::vector<std::unique_ptr<nn_network>> nn_rnd_target_instances; // id 3
+
+    // float32 networks, created through the *_f32 entry points, same nn_type numbering
+    std::vector<std::unique_ptr<nn_network>> nn_online_instances_f32;
+    std::vector<std::unique_ptr<nn_network>> nn_target_instances_f32;
+    std::vector<std::unique_ptr<nn_network>> nn_rnd_instances_f32;
+    std::vector<std::unique_ptr<nn_network>> nn_rnd_target_instances_f32;
+}
+
+// The double and float C entry points share these implementations, eT picks the instance lists
+
+using NNInstances = std::vector<std::unique_ptr<nn_network>>;
+
+template <typename eT>
+NNInstances& nn_instances(uint32_t nn_type) {
+    if constexpr (std::is_same_v<eT, float>) {
+        switch (nn_type) {
+            case 0: return nn_online_instances_f32;
+            case 1: return nn_target_instances_f32;
+            case 2: return nn_rnd_instances_f32;
+            case 3: return nn_rnd_target_instances_f32;
+        }
+    } else {
+        switch (nn_type) {
+            case 0: return nn_online_instances;
+            case 1: return nn_target_instances;
+            case 2: return nn_rnd_instances;
+            case 3: return nn_rnd_target_instances;
+        }
+    }
 
+    std::cerr << "Error: Invalid neural network type" << std::endl;
+    exit(1);
+}
+
+template <typename eT>
+nn_network* legacy_handle(uint32_t id, uint32_t nn_type) {
+    auto& instances = nn_instances<eT>(nn_type);
+    if (id >= instances.size()) {
+        std::cerr << "Error: Invalid neural network ID" << std::endl;
+        exit(1);
+    }
+    return instances[id].get();
+}
+
+// Takes ownership of handle, returns its id
+template <typename eT>
+uint32_t register_legacy(nn_network* handle, uint32_t nn_type) {
+    auto& instances = nn_instances<eT>(nn_type);
+    instances.emplace_back(handle);
+    return instances.size() - 1;
+}
+
+// DQN networks (online/target) default to the DQN hyperparams, RND networks to the RND ones
+nn_options default_options(uint32_t nn_type) {
+    nn_options options;
+    if (nn_type == 0 || nn_type == 1) {
+        options.lr_initial = dqn_params.LR_INITIAL;
+        options.beta1 = dqn_params.BETA1;
+        options.beta2 = dqn_params.BETA2;
+        options.eps = dqn_params.EPS;
+        options.max_training_steps = dqn_params.max_training_steps;
+        options.min_learning_rate = dqn_params.min_learning_rate;
+    } else {
+        options.lr_initial = rnd_params.LR_INITIAL;
+        options.beta1 = rnd_params.BETA1;
+        options.beta2 = rnd_params.BETA2;
+        options.eps = rnd_params.EPS;
+        options.max_training_steps = rnd_params.max_training_steps;
+        options.min_learning_rate = rnd_params.min_learning_rate;
+    }
+    options.loss_log_interval = telemetry_params.LOSS_LOG_INTERVAL;
+    options.loss_log_mode = telemetry_params.LOSS_LOG_MODE;
+    options.loss_flush_lines = telemetry_params.LOSS_FLUSH_LINES;
+    return options;
+}
+
+template <typename eT>
+nn_network* create_impl(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim,
+                        uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type, const nn_options* options) {
+
+    // print intializing nn
+    std::cout << "Initializing neural network with input_dim \n<" << input_dim
+              << ", output_dim: " << output_dim
+              << ", hidden_dim: " << hidden_dim
+              << ", num_m_layers: " << num_m_layers
+              << ", batch_size: " << batch_size
+              << ", nn_type (0=online, 1=target): " << nn_type
+              << ", precision: " << (std::is_same_v<eT, float> ? "float32" : "float64")
+              << ">" << std::endl;
+
+    if (nn_type > 3) {
+        std::cerr << "Error: Invalid neural network type" << std::endl;
+        return nullptr;
+    }
+    if (options == nullptr) {
+        std::cerr << "Error: No options for the neural network" << std::endl;
+        return nullptr;
+    }
+
+    try {
+        auto handle = std::make_unique<nn_network>();
+        network_slot<eT>(handle.get()) = std::make_unique<NeuralNetworkT<eT>>(input_dim, output_dim, hidden_dim,
+            num_m_layers, batch_size, nn_type, *options);
+        return handle.release();
+    } catch (const std::exception& e) {
+        std::cerr << "Init NN Error: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+template <typename eT>
+uint32_t init_nn_impl(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim,
+                      uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type) {
+    const nn_options options = default_options(nn_type);
+    nn_network* handle = create_impl<eT>(input_dim, output_dim, hidden_dim, num_m_layers, batch_size, nn_type, &options);
+    if (handle == nullptr) {
+        exit(1);
+    }
+    uint32_t id = register_legacy<eT>(handle, nn_type);
+
+    if (nn_type == 0 || nn_type == 1) {
+        // print out online and target instances
+        std::cout << "Online instances: " << nn_instances<eT>(0).size() << std::endl;
+        std::cout << "Target instances: " << nn_instances<eT>(1).size() << std::endl;
+    }
+
+    return id;
+}
+
+// Overwrite dest's weights/biases with tau * source + (1 - tau) * dest, in place. dest is
+// only rebuilt (a full copy of source) if it does not exist yet or its shape differs
+template <typename eT>
+void sync_params(const NeuralNetworkT<eT>& source, std::unique_ptr<NeuralNetworkT<eT>>& dest, double tau) {
+    if (!(tau > 0.0 && tau <= 1.0)) {
+        std::cerr << "Error: Parameter sync tau must be in (0, 1], got " << tau << std::endl;
+        exit(1);
+    }
+
+    bool same_shape = dest && dest->m_layers.size() == source.m_layers.size();
+    for (size_t i = 0; same_shape && i < source.m_layers.size(); ++i) {
+        const auto& d = dest->m_layers[i];
+        const auto& s = source.m_layers[i];
+        same_shape = d.m_weights.n_rows == s.m_weights.n_rows && d.m_weights.n_cols == s.m_weights.n_cols &&
+                     d.m_biases.n_elem == s.m_biases.n_elem;
+    }
+    if (!same_shape) {
+        dest = std::make_unique<NeuralNetworkT<eT>>(source);
+        return;
+    }
+
+    for (size_t i = 0; i < source.m_layers.size(); ++i) {
+        dest->m_layers[i].blend_parameters(source.m_layers[i], tau);
+    }
+    // a hard sync leaves dest holding exactly source's weights
+    dest->m_param_version = tau == 1.0 ? source.m_param_version : next_param_version();
+}
+
+// Both handles must hold networks of the same precision
+template <typename eT>
+void sync_handles(nn_network* source, nn_network* dest, double tau) {
+    const auto& src = as_network<eT>(source);
+    as_network<eT>(dest);
+    sync_params(src, network_slot<eT>(dest), tau);
+}
+
+void sync_params(nn_network* source, nn_network* dest, double tau) {
+    if (source != nullptr && source->f32) {
+        sync_handles<float>(source, dest, tau);
+    } else {
+        sync_handles<double>(source, dest, tau);
+    }
+}
+
+nn_network* clone_handle(nn_network* handle) {
+    auto copy = std::make_unique<nn_network>();
+    if (handle != nullptr && handle->f32) {
+        copy->f32 = std::make_unique<NeuralNetworkF>(*handle->f32);
+    } else {
+        copy->f64 = std::make_unique<NeuralNetwork>(as_network<double>(handle));
+    }
+    return copy.release();
+}
+
+// tau = 1 is a hard sync
+template <typename eT>
+void update_target_nn_impl(uint32_t online_nn_id, uint32_t target_nn_id, double tau) {
+    sync_handles<eT>(legacy_handle<eT>(online_nn_id, 0), legacy_handle<eT>(target_nn_id, 1), tau);
+}
+
+template <typename eT>
+uint32_t clone_nn_impl(uint32_t id, uint32_t nn_type) {
+    return register_legacy<eT>(clone_handle(legacy_handle<eT>(id, nn_type)), nn_type);
+}
+
+template <typename eT>
+void copy_nn_params_impl(uint32_t src_id, uint32_t dst_id, uint32_t nn_type) {
+    sync_handles<eT>(legacy_handle<eT>(src_id, nn_type), legacy_handle<eT>(dst_id, nn_type), 1.0);
+}
+
+extern "C" {
+    // predict_many jobs, same layout as in the game's nn_api.h
+    struct nn_predict_job {
+        uint32_t id;
+        uint32_t nn_type;
+        double* input_data;
+        double* output_data;
+        uint32_t batch_size;
+    };
+
+    struct nn_predict_job_f32 {
+        uint32_t id;
+        uint32_t nn_type;
+        float* input_data;
+        float* output_data;
+        uint32_t batch_size;
+    };
+
+    struct nn_job {
+        nn_network* network;
+        double* input_data;
+        double* output_data;
+        uint32_t batch_size;
+    };
+
+    struct nn_job_f32 {
+        nn_network* network;
+        float* input_data;
+        float* output_data;
+        uint32_t batch_size;
+    };
+}
+
+// Independent forward passes run concurrently. A network's inference buffers allow one pass
+// at a time, so jobs on the same network form one task and run in the order given.
+// resolve(job) is the job's handle
+template <typename eT, typename Job, typename Resolve>
+void predict_many_impl(const Job* jobs, uint32_t count, Resolve resolve) {
+    std::vector<std::pair<NeuralNetworkT<eT>*, std::vector<const Job*>>> groups;
+    for (uint32_t i = 0; i < count; ++i) {
+        NeuralNetworkT<eT>* nn = &as_network<eT>(resolve(jobs[i]));
+
+        auto same_network = [nn](const auto& group) { return group.first == nn; };
+        auto it = std::find_if(groups.begin(), groups.end(), same_network);
+        if (it == groups.end()) {
+            groups.push_back({nn, {&jobs[i]}});
+        } else {
+            it->second.push_back(&jobs[i]);
+        }
+    }
+
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(groups.size());
+    for (const auto& group : groups) {
+        tasks.emplace_back([&group]() {
+            for (const Job* job : group.second) {
+                group.first->predict(job->input_data, job->output_data, job->batch_size);
+            }
+        });
+    }
+    InferencePool::getInstance().run(tasks);
+}
+
+// options_for(saved nn_type) gives the options of the loaded network
+template <typename eT, typename OptionsFor>
+nn_network* load_impl(const char* dirname, OptionsFor options_for, uint32_t* nn_type) {
+    try {
+        NNInfo_metadata meta;
+        std::vector<LayerDenseT<eT>> layers;
+
+        // converts a model saved in the other precision to eT
+        if(!read_model(dirname, layers, meta)) {
+            throw std::runtime_error("Failed to read model");
+        }
+
+        if (meta.nn_type > 3) {
+            throw std::runtime_error("Invalid neural network type");
+        }
+
+        auto handle = std::make_unique<nn_network>();
+        auto& slot = network_slot<eT>(handle.get());
+        slot = std::make_unique<NeuralNetworkT<eT>>(meta.input_dim, meta.output_dim, meta.hidden_dim, meta.num_m_layers,
+            meta.batch_size, meta.nn_type, options_for(meta.nn_type));
+
+        auto& nn = *slot;
+        nn.m_layers = std::move(layers);
+        nn.optimizer.m_step = meta.optimizer_step; // Adam moments came with the layers
+        nn.m_telemetry.resumeAt(static_cast<uint64_t>(meta.optimizer_step));
+        nn.m_param_version = next_param_version();
+
+        if(nn.m_activations.size() != nn.m_layers.size()) {
+            nn.m_activations.clear();
+            for (size_t i = 0; i < nn.m_layers.size(); ++i) {
+                nn.m_activations.emplace_back();
+            }
+        }
+
+        if (nn_type != nullptr) {
+            *nn_type = meta.nn_type;
+        }
+        return handle.release();
+    } catch(const std::exception& e) {
+        std::cerr << "Load NN Error: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+template <typename eT>
+uint32_t load_nn_model_impl(const char* dirname, uint32_t nn_type) {
+    uint32_t saved_type = 0;
+    nn_network* handle = load_impl<eT>(dirname, default_options, &saved_type);
+    if (handle == nullptr) {
+        return UINT32_MAX;
+    }
+    if (saved_type != nn_type) {
+        std::cerr << "Warning: model in " << dirname << " was saved as nn_type " << saved_type
+                  << ", loading it as that type instead of " << nn_type << std::endl;
+    }
+    return register_legacy<eT>(handle, saved_type);
+}
+
+bool save_handle(nn_network* handle, const char* dirname) {
+    return with_network(handle, [dirname](auto& nn) { return nn.save_model(dirname); });
+}
+
+uint64_t save_handle_async(nn_network* handle, const char* dirname) {
+    try {
+        return with_network(handle, [dirname](auto& nn) { return nn.save_model_async(dirname); });
+    } catch (const std::exception& e) {
+        std::cerr << "Checkpoint Error: " << e.what() << std::endl;
+        return 0;
+    }
+}
+
+extern "C" {
     uint32_t parse_nn_params() {
         std::cout << "Hyperparameter Initilization for Neural Network" << std::endl;
-        
+
         bool status = parse_dqn_params("../neural_network", dqn_params);
-        
+
         if (status == false)
             return 1;
 
@@ -316,6 +791,10 @@ extern "C" {
         if (status == false)
             return 1;
 
+        status = parse_telemetry_params("../neural_network", telemetry_params);
+        if (status == false)
+            return 1;
+
         std::cout << "RND Initial Learning Rate: " << rnd_params.LR_INITIAL << std::endl;
         std::cout << "RND BETA1: " << rnd_params.BETA1 << std::endl;
         std::cout << "RND BETA2: " << rnd_params.BETA2<< std::endl;
@@ -328,219 +807,224 @@ extern "C" {
         return 0;
     }
 
-    uint32_t init_nn(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim, 
-                 uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type) {
+    // Handle API
 
-        // print intializing nn
-        std::cout << "Initializing neural network with input_dim \n<" << input_dim 
-                  << ", output_dim: " << output_dim 
-                  << ", hidden_dim: " << hidden_dim 
-                  << ", num_m_layers: " << num_m_layers 
-                  << ", batch_size: " << batch_size
-                  << ", nn_type (0=online, 1=target): " << nn_type
-                  << ">" << std::endl;
-
-        if (nn_type == 0) {
-            nn_online_instances.push_back(std::make_unique<NeuralNetwork>(input_dim, output_dim, hidden_dim, num_m_layers, batch_size, nn_type, 
-                dqn_params.LR_INITIAL, dqn_params.BETA1, dqn_params.BETA2, dqn_params.EPS, dqn_params.max_training_steps, dqn_params.min_learning_rate));
-            // print out online and target instances
-            std::cout << "Online instances: " << nn_online_instances.size() << std::endl;
-            std::cout << "Target instances: " << nn_target_instances.size() << std::endl;
-            return nn_online_instances.size() - 1;
-        } else if (nn_type == 1) {
-            nn_target_instances.push_back(std::make_unique<NeuralNetwork>(input_dim, output_dim, hidden_dim, num_m_layers, batch_size, nn_type, 
-                dqn_params.LR_INITIAL, dqn_params.BETA1, dqn_params.BETA2, dqn_params.EPS, dqn_params.max_training_steps, dqn_params.min_learning_rate));
-            // print out online and target instances
-            std::cout << "Online instances: " << nn_online_instances.size() << std::endl;
-            std::cout << "Target instances: " << nn_target_instances.size() << std::endl;
-            return nn_target_instances.size() - 1;
-        }
-        else if (nn_type == 2) {
-            nn_rnd_instances.push_back(std::make_unique<NeuralNetwork>(input_dim, output_dim, hidden_dim, num_m_layers, batch_size, nn_type, 
-                rnd_params.LR_INITIAL, rnd_params.BETA1, rnd_params.BETA2, rnd_params.EPS, rnd_params.max_training_steps, rnd_params.min_learning_rate));
-            return nn_rnd_instances.size() - 1;
-        } else if (nn_type == 3) {
-            nn_rnd_target_instances.push_back(std::make_unique<NeuralNetwork>(input_dim, output_dim, hidden_dim, num_m_layers, batch_size, nn_type, 
-                rnd_params.LR_INITIAL, rnd_params.BETA1, rnd_params.BETA2, rnd_params.EPS, rnd_params.max_training_steps, rnd_params.min_learning_rate));
-            return nn_rnd_target_instances.size() - 1;
+    nn_options nn_default_options(uint32_t nn_type) {
+        return default_options(nn_type);
+    }
+
+    nn_network* nn_create(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim,
+                          uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type, const nn_options* options) {
+        return create_impl<double>(input_dim, output_dim, hidden_dim, num_m_layers, batch_size, nn_type, options);
+    }
+
+    nn_network* nn_create_f32(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim,
+                              uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type, const nn_options* options) {
+        return create_impl<float>(input_dim, output_dim, hidden_dim, num_m_layers, batch_size, nn_type, options);
+    }
+
+    nn_network* nn_load(const char* dirname, const nn_options* options) {
+        if (options == nullptr) {
+            std::cerr << "Error: No options for the neural network" << std::endl;
+            return nullptr;
         }
-        else {
-            std::cerr << "Error: Invalid neural network type" << std::endl;
-            exit(1);
+        return load_impl<double>(dirname, [options](uint32_t) { return *options; }, nullptr);
+    }
+
+    nn_network* nn_load_f32(const char* dirname, const nn_options* options) {
+        if (options == nullptr) {
+            std::cerr << "Error: No options for the neural network" << std::endl;
+            return nullptr;
         }
+        return load_impl<float>(dirname, [options](uint32_t) { return *options; }, nullptr);
+    }
+
+    nn_network* nn_clone(nn_network* network) {
+        return clone_handle(network);
+    }
+
+    void nn_destroy(nn_network* network) {
+        delete network;
+    }
+
+    void nn_predict(nn_network* network, double* input_data, double* output_data, uint32_t batch_size) {
+        as_network<double>(network).predict(input_data, output_data, batch_size);
+    }
+
+    void nn_predict_f32(nn_network* network, float* input_data, float* output_data, uint32_t batch_size) {
+        as_network<float>(network).predict(input_data, output_data, batch_size);
+    }
+
+    void nn_predict_many(const nn_job* jobs, uint32_t count) {
+        predict_many_impl<double>(jobs, count, [](const nn_job& job) { return job.network; });
+    }
+
+    void nn_predict_many_f32(const nn_job_f32* jobs, uint32_t count) {
+        predict_many_impl<float>(jobs, count, [](const nn_job_f32& job) { return job.network; });
+    }
+
+    void nn_train(nn_network* network, double* input_data, double* target_data, uint32_t batch_size) {
+        as_network<double>(network).train(input_data, target_data, batch_size);
+    }
+
+    void nn_train_f32(nn_network* network, float* input_data, float* target_data, uint32_t batch_size) {
+        as_network<float>(network).train(input_data, target_data, batch_size);
+    }
+
+    void nn_train_weighted(nn_network* network, double* input_data, double* target_data, double* sample_weights, uint32_t batch_size) {
+        as_network<double>(network).train(input_data, target_data, batch_size, sample_weights);
+    }
+
+    void nn_train_weighted_f32(nn_network* network, float* input_data, float* target_data, float* sample_weights, uint32_t batch_size) {
+        as_network<float>(network).train(input_data, target_data, batch_size, sample_weights);
+    }
+
+    void nn_sync(nn_network* source, nn_network* dest, double tau) {
+        sync_params(source, dest, tau);
+    }
+
+    void nn_randomize(nn_network* network) {
+        with_network(network, [](auto& nn) { return nn.randomize_weights(nn.m_layers); });
+    }
+
+    uint64_t nn_version(nn_network* network) {
+        return with_network(network, [](auto& nn) { return nn.m_param_version; });
+    }
+
+    bool nn_save(nn_network* network, const char* dirname) {
+        return save_handle(network, dirname);
+    }
+
+    uint64_t nn_save_async(nn_network* network, const char* dirname) {
+        return save_handle_async(network, dirname);
+    }
+
+    int32_t checkpoint_status(uint64_t ticket) {
+        return CheckpointWriter::getInstance().status(ticket);
+    }
+
+    uint32_t wait_checkpoints() {
+        return CheckpointWriter::getInstance().wait();
+    }
+
+    // Id-based API
+
+    uint32_t init_nn(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim,
+                 uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type) {
+        return init_nn_impl<double>(input_dim, output_dim, hidden_dim, num_m_layers, batch_size, nn_type);
     }
 
     void train_nn(uint32_t id, uint32_t nn_type, double* input_data, double* target_data, uint32_t batch_size) {
-        if (nn_type == 0) {
-            nn_online_instances[id]->train(input_data, target_data);
-        }
-        else if (nn_type == 1) {
-            nn_target_instances[id]->train(input_data, target_data);
-        }
-        else if (nn_type == 2) {
-            nn_rnd_instances[id]->train(input_data, target_data);
-        }
-        else if (nn_type == 3) {
-            nn_rnd_target_instances[id]->train(input_data, target_data);
-        }
-        // If nn_type is not recognized, print an error message
-        else {
-            std::cerr << "Error: Invalid neural network type" << std::endl;
-            exit(1);
-        }
+        nn_train(legacy_handle<double>(id, nn_type), input_data, target_data, batch_size);
+    }
+
+    void train_nn_weighted(uint32_t id, uint32_t nn_type, double* input_data, double* target_data, double* sample_weights, uint32_t batch_size) {
+        nn_train_weighted(legacy_handle<double>(id, nn_type), input_data, target_data, sample_weights, batch_size);
     }
 
     // Prediction function converts arma::mat to double*
     void predict_nn(uint32_t id, uint32_t nn_type, double* input_data, double* output_data, uint32_t batch_size) {
-        if (nn_type == 0) {
-            nn_online_instances[id]->predict(input_data, output_data, batch_size);
-        }
-        else if (nn_type == 1) {
-            nn_target_instances[id]->predict(input_data, output_data, batch_size);
-        }
-        else if (nn_type == 2) {
-            nn_rnd_instances[id]->predict(input_data, output_data, batch_size);
-        }
-        else if (nn_type == 3) {
-            nn_rnd_target_instances[id]->predict(input_data, output_data, batch_size);
-        }
-    
-        // If nn_type is not recognized, print an error message
-        else {
-            std::cerr << "Error: Invalid neural network type" << std::endl;
-            exit(1);
-        }
+        nn_predict(legacy_handle<double>(id, nn_type), input_data, output_data, batch_size);
+    }
+
+    void predict_many(const nn_predict_job* jobs, uint32_t count) {
+        predict_many_impl<double>(jobs, count, [](const nn_predict_job& job) { return legacy_handle<double>(job.id, job.nn_type); });
     }
 
     void update_target_nn(uint32_t online_nn_id, uint32_t target_nn_id) {
-        // Check if the online and target neural networks exist
-        if (online_nn_id >= nn_online_instances.size() || target_nn_id >= nn_target_instances.size()) {
-            std::cerr << "Error: Invalid neural network ID" << std::endl;
-            exit(1);
-        }
+        update_target_nn_impl<double>(online_nn_id, target_nn_id, 1.0);
+    }
+
+    void soft_update_target_nn(uint32_t online_nn_id, uint32_t target_nn_id, double tau) {
+        update_target_nn_impl<double>(online_nn_id, target_nn_id, tau);
+    }
+
+    uint32_t clone_nn(uint32_t id, uint32_t nn_type) {
+        return clone_nn_impl<double>(id, nn_type);
+    }
 
-        nn_target_instances[target_nn_id] = std::make_unique<NeuralNetwork>(*nn_online_instances[online_nn_id]);
+    void copy_nn_params(uint32_t src_id, uint32_t dst_id, uint32_t nn_type) {
+        copy_nn_params_impl<double>(src_id, dst_id, nn_type);
+    }
+
+    uint64_t nn_params_version(uint32_t id, uint32_t nn_type) {
+        return nn_version(legacy_handle<double>(id, nn_type));
     }
 
     bool save_nn_model(uint32_t id, uint32_t nn_type, const char* dirname) {
-        if (nn_type == 0) {
-            return nn_online_instances[id]->save_model(dirname);
-        }
-        else if (nn_type == 1) {
-            return nn_target_instances[id]->save_model(dirname);
-        }
-        else if (nn_type == 2) {
-            return nn_rnd_instances[id]->save_model(dirname);
-        }
-        else if (nn_type == 3) {
-            return nn_rnd_target_instances[id]->save_model(dirname);
-        }
-        // If nn_type is not recognized, print an error message
-        std::cerr << "Error: Invalid neural network type" << std::endl;
-        return false;
+        return nn_save(legacy_handle<double>(id, nn_type), dirname);
     }
 
     uint32_t load_nn_model(const char* dirname, uint32_t nn_type) {
-        try {
-            NNInfo_metadata meta;
-            std::vector<LayerDense> layers;
-            
-            if(!read_model(dirname, layers, meta)) {
-                throw std::runtime_error("Failed to read model");
-            }
+        return load_nn_model_impl<double>(dirname, nn_type);
+    }
 
-            //auto& instances = (nn_type == 0) ? nn_online_instances : nn_target_instances;
-            auto& instances = (nn_type == 0) ? nn_online_instances :
-                              (nn_type == 1) ? nn_target_instances :
-                              (nn_type == 2) ? nn_rnd_instances :
-                              nn_rnd_target_instances;
-            
-            /*
-            instances.push_back(std::make_unique<NeuralNetwork>(
-                meta.input_dim,
-                meta.output_dim,
-                meta.hidden_dim,
-                meta.num_m_layers,
-                meta.batch_size,
-                meta.nn_type
-            ));*/
-
-            if (meta.nn_type == 0) {
-                nn_online_instances.push_back(std::make_unique<NeuralNetwork>(
-                    meta.input_dim,
-                    meta.output_dim,
-                    meta.hidden_dim,
-                    meta.num_m_layers,
-                    meta.batch_size,
-                    meta.nn_type,
-                    dqn_params.LR_INITIAL, dqn_params.BETA1, dqn_params.BETA2, dqn_params.EPS, dqn_params.max_training_steps, dqn_params.min_learning_rate));
-            } else if (meta.nn_type == 1) {
-                nn_target_instances.push_back(std::make_unique<NeuralNetwork>(
-                    meta.input_dim,
-                    meta.output_dim,
-                    meta.hidden_dim,
-                    meta.num_m_layers,
-                    meta.batch_size,
-                    meta.nn_type,
-                    dqn_params.LR_INITIAL, dqn_params.BETA1, dqn_params.BETA2, dqn_params.EPS, dqn_params.max_training_steps, dqn_params.min_learning_rate));
-            } else if (meta.nn_type == 2) {
-                nn_rnd_instances.push_back(std::make_unique<NeuralNetwork>(
-                    meta.input_dim,
-                    meta.output_dim,
-                    meta.hidden_dim,
-                    meta.num_m_layers,
-                    meta.batch_size,
-                    meta.nn_type,
-                    rnd_params.LR_INITIAL, rnd_params.BETA1, rnd_params.BETA2, rnd_params.EPS, rnd_params.max_training_steps, rnd_params.min_learning_rate));
-            } else if (meta.nn_type == 3) {
-                nn_rnd_target_instances.push_back(std::make_unique<NeuralNetwork>(
-                    meta.input_dim,
-                    meta.output_dim,
-                    meta.hidden_dim,
-                    meta.num_m_layers,
-                    meta.batch_size,
-                    meta.nn_type,
-                    rnd_params.LR_INITIAL, rnd_params.BETA1, rnd_params.BETA2, rnd_params.EPS, rnd_params.max_training_steps, rnd_params.min_learning_rate));
-            } else {
-                throw std::runtime_error("Invalid neural network type");
-            }
+    uint64_t save_nn_model_async(uint32_t id, uint32_t nn_type, const char* dirname) {
+        return nn_save_async(legacy_handle<double>(id, nn_type), dirname);
+    }
 
-            auto& nn = *instances.back();
-            nn.m_layers = std::move(layers);
-    
-            if(nn.m_activations.size() != nn.m_layers.size()) {
-                nn.m_activations.clear();
-                for (size_t i = 0; i < nn.m_layers.size(); ++i) {
-                    nn.m_activations.emplace_back();
-                }
-            }
+    uint32_t randomize_weights(uint32_t id, uint32_t nn_type) {
+        nn_randomize(legacy_handle<double>(id, nn_type));
+        return 0;
+    }
 
-            return instances.size() - 1;
-        } catch(const std::exception& e) {
-            std::cerr << "Load NN Error: " << e.what() << std::endl;
-            return UINT32_MAX;
-        }
+    // float32 variants, operating on their own set of networks
+
+    uint32_t init_nn_f32(uint32_t input_dim, uint32_t output_dim, uint32_t hidden_dim,
+                 uint32_t num_m_layers, uint32_t batch_size, uint32_t nn_type) {
+        return init_nn_impl<float>(input_dim, output_dim, hidden_dim, num_m_layers, batch_size, nn_type);
     }
 
-    uint32_t randomize_weights(uint32_t id, uint32_t nn_type) {
-        if (nn_type == 0) {
-            return nn_online_instances[id]->randomize_weights(nn_online_instances[id]->m_layers);
-        }
-        else if (nn_type == 1) {
-            return nn_target_instances[id]->randomize_weights(nn_target_instances[id]->m_layers);
-        }
-        else if (nn_type == 2) {
-            return nn_rnd_instances[id]->randomize_weights(nn_rnd_instances[id]->m_layers);
-        }
-        else if (nn_type == 3) {
-            return nn_rnd_target_instances[id]->randomize_weights(nn_rnd_target_instances[id]->m_layers);
-        }
-        // If nn_type is not recognized, print an error message
-        std::cerr << "Error: Invalid neural network type" << std::endl;
-        exit(1);
+    void train_nn_f32(uint32_t id, uint32_t nn_type, float* input_data, float* target_data, uint32_t batch_size) {
+        nn_train_f32(legacy_handle<float>(id, nn_type), input_data, target_data, batch_size);
+    }
+
+    void train_nn_weighted_f32(uint32_t id, uint32_t nn_type, float* input_data, float* target_data, float* sample_weights, uint32_t batch_size) {
+        nn_train_weighted_f32(legacy_handle<float>(id, nn_type), input_data, target_data, sample_weights, batch_size);
+    }
+
+    void predict_nn_f32(uint32_t id, uint32_t nn_type, float* input_data, float* output_data, uint32_t batch_size) {
+        nn_predict_f32(legacy_handle<float>(id, nn_type), input_data, output_data, batch_size);
+    }
+
+    void predict_many_f32(const nn_predict_job_f32* jobs, uint32_t count) {
+        predict_many_impl<float>(jobs, count, [](const nn_predict_job_f32& job) { return legacy_handle<float>(job.id, job.nn_type); });
+    }
+
+    void update_target_nn_f32(uint32_t online_nn_id, uint32_t target_nn_id) {
+        update_target_nn_impl<float>(online_nn_id, target_nn_id, 1.0);
+    }
+
+    void soft_update_target_nn_f32(uint32_t online_nn_id, uint32_t target_nn_id, double tau) {
+        update_target_nn_impl<float>(online_nn_id, target_nn_id, tau);
+    }
+
+    uint32_t clone_nn_f32(uint32_t id, uint32_t nn_type) {
+        return clone_nn_impl<float>(id, nn_type);
+    }
+
+    void copy_nn_params_f32(uint32_t src_id, uint32_t dst_id, uint32_t nn_type) {
+        copy_nn_params_impl<float>(src_id, dst_id, nn_type);
     }
 
+    uint64_t nn_params_version_f32(uint32_t id, uint32_t nn_type) {
+        return nn_version(legacy_handle<float>(id, nn_type));
+    }
 
+    bool save_nn_model_f32(uint32_t id, uint32_t nn_type, const char* dirname) {
+        return nn_save(legacy_handle<float>(id, nn_type), dirname);
+    }
 
+    uint32_t load_nn_model_f32(const char* dirname, uint32_t nn_type) {
+        return load_nn_model_impl<float>(dirname, nn_type);
+    }
 
-}
\ No newline at end of file
+    uint64_t save_nn_model_async_f32(uint32_t id, uint32_t nn_type, const char* dirname) {
+        return nn_save_async(legacy_handle<float>(id, nn_type), dirname);
+    }
+
+    uint32_t randomize_weights_f32(uint32_t id, uint32_t nn_type) {
+        nn_randomize(legacy_handle<float>(id, nn_type));
+        return 0;
+    }
+}
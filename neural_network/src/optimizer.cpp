@@ -18,7 +18,7 @@ void Optimizer_SGD::pre_update_params() {
 void Optimizer_SGD::update(LayerDense& layer) {
     // If the gradient is positive, the loss increases as the weight increases. Subtracting reduces the weight to lower the loss.
 
-    arma::mat weight_updates = m_momentum * layer.m_velocity_weights - m_learning_rate * layer.m_dweights.t();
+    arma::mat weight_updates = m_momentum * layer.m_velocity_weights - m_learning_rate * layer.m_dweights;
     layer.m_velocity_weights = weight_updates;
 
     arma::mat bias_updates = m_momentum * layer.m_velocity_biases - m_learning_rate * layer.m_dbiases;
@@ -56,41 +56,76 @@ Optimizer_Adam::Optimizer_Adam(double learning_rate,
 void Optimizer_Adam::pre_update_params() {
     m_step += 1;
     m_learning_rate = m_lr_scheduler.get_learning_rate(m_step);
+
+    // Bias corrections only depend on the step, so compute them once for every layer
+    m_momentum_correction = 1.0 / (1.0 - std::pow(m_beta1, m_step));
+    m_cache_correction = 1.0 / (1.0 - std::pow(m_beta2, m_step));
 }
 
-void Optimizer_Adam::update(LayerDense &layer) {
-    // If layer momentums not initialized, set to zero mats
-    if (layer.m_weight_momentums.n_elem == 0) {
-        layer.m_weight_momentums = arma::zeros<arma::mat>(layer.m_weights.n_rows, layer.m_weights.n_cols);
-        layer.m_weight_cache     = arma::zeros<arma::mat>(layer.m_weights.n_rows, layer.m_weights.n_cols);
-        layer.m_bias_momentums   = arma::zeros<arma::rowvec>(layer.m_biases.n_cols);
-        layer.m_bias_cache       = arma::zeros<arma::rowvec>(layer.m_biases.n_cols);
-    }
+// One pass over a parameter tensor: updates the momentum and cache in place, then the
+// parameter, without any temporaries. Returns a sum of everything written, which is only
+// non-finite if one of the new values is NaN/Inf, so the caller can check it once
+template <typename eT>
+static eT adam_sweep(eT* params, eT* momentums, eT* cache, const eT* grads, size_t n,
+                     eT beta1, eT beta2, eT learning_rate, eT momentum_correction, eT cache_correction, eT eps) {
+    const eT one_minus_beta1 = eT(1) - beta1;
+    const eT one_minus_beta2 = eT(1) - beta2;
 
-    // Update momentums with current gradients
-    layer.m_weight_momentums = m_beta1 * layer.m_weight_momentums + (1.0 - m_beta1) * layer.m_dweights.t();
-    layer.m_bias_momentums   = m_beta1 * layer.m_bias_momentums   + (1.0 - m_beta1) * layer.m_dbiases;
+    eT check = eT(0);
+    for (size_t i = 0; i < n; ++i) {
+        const eT g = grads[i];
+        const eT m = beta1 * momentums[i] + one_minus_beta1 * g;
+        const eT v = beta2 * cache[i] + one_minus_beta2 * g * g;
 
-    // Update cache (RMS prop)
-    layer.m_weight_cache = m_beta2 * layer.m_weight_cache + (1.0 - m_beta2) * arma::square(layer.m_dweights.t());
-    layer.m_bias_cache   = m_beta2 * layer.m_bias_cache   + (1.0 - m_beta2) * arma::square(layer.m_dbiases);
+        const eT p = params[i] - learning_rate * (m * momentum_correction) / (std::sqrt(v * cache_correction) + eps);
 
+        momentums[i] = m;
+        cache[i] = v;
+        params[i] = p;
 
-    // Correct bias in moment estimates
-    arma::mat weight_momentums_corrected = layer.m_weight_momentums / (1.0 - std::pow(m_beta1, m_step));
-    arma::rowvec bias_momentums_corrected = layer.m_bias_momentums   / (1.0 - std::pow(m_beta1, m_step));
-    arma::mat weight_cache_corrected      = layer.m_weight_cache     / (1.0 - std::pow(m_beta2, m_step));
-    arma::rowvec bias_cache_corrected     = layer.m_bias_cache       / (1.0 - std::pow(m_beta2, m_step));
+        check += p + m + v;
+    }
 
-    // Parameter update
-    layer.m_weights -= m_learning_rate * weight_momentums_corrected /
-                       (arma::sqrt(weight_cache_corrected) + m_eps);
+    return check;
+}
 
-    layer.m_biases  -= m_learning_rate * bias_momentums_corrected   /
-                       (arma::sqrt(bias_cache_corrected)   + m_eps);
+template <typename eT>
+void Optimizer_Adam::update(LayerDenseT<eT> &layer) {
+    using mat_type = typename LayerDenseT<eT>::mat_type;
+    using rowvec_type = typename LayerDenseT<eT>::rowvec_type;
 
+    // If layer momentums not initialized, set to zero mats
+    if (layer.m_weight_momentums.n_elem == 0) {
+        layer.m_weight_momentums = arma::zeros<mat_type>(layer.m_weights.n_rows, layer.m_weights.n_cols);
+        layer.m_weight_cache     = arma::zeros<mat_type>(layer.m_weights.n_rows, layer.m_weights.n_cols);
+        layer.m_bias_momentums   = arma::zeros<rowvec_type>(layer.m_biases.n_cols);
+        layer.m_bias_cache       = arma::zeros<rowvec_type>(layer.m_biases.n_cols);
+    }
+
+    if (layer.m_dweights.n_rows != layer.m_weights.n_rows || layer.m_dweights.n_cols != layer.m_weights.n_cols) {
+        std::cerr << "Error: Weight gradients do not match the weights shape" << std::endl;
+        exit(1);
+    }
 
-    // print check for all values that may cause gradient explosion (nan or inf)
+    const eT beta1 = static_cast<eT>(m_beta1);
+    const eT beta2 = static_cast<eT>(m_beta2);
+    const eT learning_rate = static_cast<eT>(m_learning_rate);
+    const eT momentum_correction = static_cast<eT>(m_momentum_correction);
+    const eT cache_correction = static_cast<eT>(m_cache_correction);
+    const eT eps = static_cast<eT>(m_eps);
+
+    eT check = adam_sweep(layer.m_weights.memptr(), layer.m_weight_momentums.memptr(), layer.m_weight_cache.memptr(),
+                          layer.m_dweights.memptr(), layer.m_weights.n_elem,
+                          beta1, beta2, learning_rate, momentum_correction, cache_correction, eps);
+    check += adam_sweep(layer.m_biases.memptr(), layer.m_bias_momentums.memptr(), layer.m_bias_cache.memptr(),
+                        layer.m_dbiases.memptr(), layer.m_biases.n_elem,
+                        beta1, beta2, learning_rate, momentum_correction, cache_correction, eps);
+
+    if (std::isfinite(check)) {
+        return;
+    }
+
+    // Something went NaN/Inf (gradient explosion), find which tensor and print it
     if (layer.m_weights.has_nan() || layer.m_weights.has_inf()) {
         std::cerr << "Error: Weights contain NaN or Inf values after Adam update." << std::endl;
         std::cerr << "Weights:\n";
@@ -130,6 +165,9 @@ void Optimizer_Adam::update(LayerDense &layer) {
     
 }
 
+template void Optimizer_Adam::update<double>(LayerDenseT<double> &layer);
+template void Optimizer_Adam::update<float>(LayerDenseT<float> &layer);
+
 void Optimizer_Adam::post_update_params() {
     //m_step += 1;
 }
\ No newline at end of file